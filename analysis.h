@@ -0,0 +1,389 @@
+#ifndef _ANALYSIS__H
+#define _ANALYSIS__H
+
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <sstream>
+#include <stdint.h>
+#include <string>
+#include <vector>
+#include "defs.h"
+
+#define CELL_COUNT (BOARD_SIZE * BOARD_SIZE)
+#define SOLVER_NODE_LIMIT 2000000 // Giới hạn số nút cho bộ giải trên bàn lớn (cho cả một lần phân tích)
+#define SOLVER_DEPTH_LIMIT 80
+
+enum MoveLabel { MOVE_OPTIMAL, MOVE_NEUTRAL, MOVE_WASTED };
+
+// Bàn hợp lệ: mỗi giá trị 0..CELL_COUNT-1 xuất hiện đúng một lần
+inline bool isPermutation(const int* cells) {
+    bool seen[CELL_COUNT] = {false};
+    for (int i = 0; i < CELL_COUNT; i++) {
+        if (cells[i] < 0 || cells[i] >= CELL_COUNT || seen[cells[i]]) return false;
+        seen[cells[i]] = true;
+    }
+    return true;
+}
+
+#if BOARD_SIZE == 3
+#define CELLS_MASK ((1ULL << (4 * CELL_COUNT)) - 1)
+
+// Khoảng cách chính xác tới trạng thái đích cho mọi bàn 3x3.
+// Bảng được xây một lần bằng BFS từ đích, tra cứu bằng thứ hạng hoán vị.
+struct DistanceTable {
+    std::vector<unsigned char> dist; // 0xFF = không tới được
+    bool built;
+
+    DistanceTable() : built(false) {}
+
+    static int factorial(int n) {
+        int f = 1;
+        for (int i = 2; i <= n; i++) f *= i;
+        return f;
+    }
+
+    // Thứ hạng Lehmer trong O(n): số giá trị nhỏ hơn còn lại = v - số giá trị nhỏ hơn đã gặp
+    static int rank(const int* cells) {
+        int r = 0;
+        unsigned seen = 0;
+        for (int i = 0; i < CELL_COUNT; i++) {
+            int v = cells[i];
+            r = r * (CELL_COUNT - i) + v - __builtin_popcount(seen & ((1u << v) - 1));
+            seen |= 1u << v;
+        }
+        return r;
+    }
+
+    static int rankPacked(uint64_t packed) {
+        int r = 0;
+        unsigned seen = 0;
+        for (int i = 0; i < CELL_COUNT; i++) {
+            int v = (int)((packed >> (4 * i)) & 0xF);
+            r = r * (CELL_COUNT - i) + v - __builtin_popcount(seen & ((1u << v) - 1));
+            seen |= 1u << v;
+        }
+        return r;
+    }
+
+    // BFS theo từng tầng. Hàng đợi giữ bàn dạng 4 bit mỗi ô, vị trí ô trống ở 8 bit cao,
+    // nên không phải giải mã thứ hạng hay tìm lại ô trống cho mỗi trạng thái.
+    void build() {
+        if (built) return;
+        dist.assign(factorial(CELL_COUNT), 0xFF);
+
+        uint64_t goal = 0;
+        for (int i = 0; i < CELL_COUNT - 1; i++) goal |= (uint64_t)(i + 1) << (4 * i);
+        goal |= (uint64_t)(CELL_COUNT - 1) << 56;
+
+        std::vector<uint64_t> queue;
+        queue.reserve(dist.size() / 2);
+        dist[rankPacked(goal & CELLS_MASK)] = 0;
+        queue.push_back(goal);
+
+        const int dr[4] = {-1, 1, 0, 0};
+        const int dc[4] = {0, 0, -1, 1};
+        size_t head = 0;
+        for (unsigned char depth = 1; head < queue.size(); depth++) {
+            size_t levelEnd = queue.size();
+            for (; head < levelEnd; head++) {
+                uint64_t state = queue[head];
+                int empty = (int)(state >> 56);
+                uint64_t cells = state & CELLS_MASK;
+                int er = empty / BOARD_SIZE, ec = empty % BOARD_SIZE;
+                for (int d = 0; d < 4; d++) {
+                    int r = er + dr[d], c = ec + dc[d];
+                    if (r < 0 || r >= BOARD_SIZE || c < 0 || c >= BOARD_SIZE) continue;
+                    int next = r * BOARD_SIZE + c;
+                    uint64_t tile = (cells >> (4 * next)) & 0xF;
+                    uint64_t nextCells = cells ^ (tile << (4 * next)) ^ (tile << (4 * empty));
+                    int nextRank = rankPacked(nextCells);
+                    if (dist[nextRank] == 0xFF) {
+                        dist[nextRank] = depth;
+                        queue.push_back(nextCells | ((uint64_t)next << 56));
+                    }
+                }
+            }
+        }
+        built = true;
+    }
+
+    int lookup(const int* cells) const {
+        unsigned char d = dist[rank(cells)];
+        return d == 0xFF ? -1 : d;
+    }
+};
+
+inline DistanceTable& getDistanceTable() {
+    static DistanceTable table;
+    return table;
+}
+#endif
+
+// Bộ giải IDA* có giới hạn cho bàn lớn hơn 3x3. Trả về -1 nếu vượt giới hạn.
+// Giới hạn số nút tính cho cả đời bộ giải, không phải cho từng lần giải.
+struct BoundedSolver {
+    int cells[CELL_COUNT];
+    long nodes;
+
+    BoundedSolver() : nodes(0) {}
+
+    bool exhausted() const {
+        return nodes > SOLVER_NODE_LIMIT;
+    }
+
+    static int manhattan(const int* board) {
+        int total = 0;
+        for (int i = 0; i < CELL_COUNT; i++) {
+            int v = board[i];
+            if (v == EMPTY_CELL) continue;
+            int target = v - 1;
+            total += abs(i / BOARD_SIZE - target / BOARD_SIZE) + abs(i % BOARD_SIZE - target % BOARD_SIZE);
+        }
+        return total;
+    }
+
+    // Trả về độ sâu tìm thấy, hoặc ngưỡng mới (> bound) nếu chưa thấy
+    int search(int empty, int g, int bound, int prevEmpty, int h, bool& found) {
+        int f = g + h;
+        if (f > bound) return f;
+        if (h == 0) {
+            found = true;
+            return g;
+        }
+        if (++nodes > SOLVER_NODE_LIMIT) return -1;
+
+        int minNext = 1 << 30;
+        const int dr[4] = {-1, 1, 0, 0};
+        const int dc[4] = {0, 0, -1, 1};
+        int er = empty / BOARD_SIZE, ec = empty % BOARD_SIZE;
+        for (int d = 0; d < 4; d++) {
+            int r = er + dr[d], c = ec + dc[d];
+            if (r < 0 || r >= BOARD_SIZE || c < 0 || c >= BOARD_SIZE) continue;
+            int next = r * BOARD_SIZE + c;
+            if (next == prevEmpty) continue;
+
+            int v = cells[next];
+            int target = v - 1;
+            int tr = target / BOARD_SIZE, tc = target % BOARD_SIZE;
+            int newH = h - (abs(r - tr) + abs(c - tc)) + (abs(er - tr) + abs(ec - tc));
+            cells[empty] = v;
+            cells[next] = EMPTY_CELL;
+            int t = search(next, g + 1, bound, empty, newH, found);
+            cells[next] = v;
+            cells[empty] = EMPTY_CELL;
+            if (found || t < 0) return t;
+            if (t < minNext) minNext = t;
+        }
+        return minNext;
+    }
+
+    int solve(const int* board) {
+        memcpy(cells, board, sizeof(cells));
+        int empty = 0;
+        while (cells[empty] != EMPTY_CELL) empty++;
+        int h = manhattan(cells);
+        int bound = h;
+        while (bound <= SOLVER_DEPTH_LIMIT) {
+            bool found = false;
+            int t = search(empty, 0, bound, -1, h, found);
+            if (found) return t;
+            if (t < 0) return -1;
+            bound = t;
+        }
+        return -1;
+    }
+
+    // Khoảng cách của bàn ngay sau một bước, khi bàn trước đó cách đích `previous` bước.
+    // Mỗi bước đổi khoảng cách đúng 1, nên chỉ cần một lượt tìm với ngưỡng previous - 1.
+    int solveNext(const int* board, int previous) {
+        if (previous < 0 || exhausted()) return -1;
+        if (previous == 0) return 1;
+        memcpy(cells, board, sizeof(cells));
+        int empty = 0;
+        while (cells[empty] != EMPTY_CELL) empty++;
+        int h = manhattan(cells);
+        if (h > previous - 1) return previous + 1;
+        bool found = false;
+        int t = search(empty, 0, previous - 1, -1, h, found);
+        if (found) return previous - 1;
+        return t < 0 ? -1 : previous + 1;
+    }
+};
+
+// Khoảng cách chính xác tới đích, -1 nếu không xác định được
+inline int distanceToGoal(const int* cells) {
+#if BOARD_SIZE == 3
+    DistanceTable& table = getDistanceTable();
+    table.build();
+    return table.lookup(cells);
+#else
+    BoundedSolver solver;
+    return solver.solve(cells);
+#endif
+}
+
+struct GameAnalysis {
+    std::vector<MoveLabel> labels;
+    int totalMoves;
+    int startDistance;
+    int optimalMoves, neutralMoves, wastedMoves;
+    int efficiency;     // Phần trăm: số bước tối ưu / số bước đã đi
+    int longestDetour;  // Số bước dài nhất đi lệch khỏi khoảng cách tốt nhất
+    int detourStart;    // Bước (tính từ 1) bắt đầu đoạn lệch dài nhất, -1 nếu không có
+    int firstMistake;   // Bước sai đầu tiên (tính từ 1), -1 nếu không có
+
+    GameAnalysis() { reset(); }
+
+    void reset() {
+        labels.clear();
+        totalMoves = 0;
+        startDistance = -1;
+        optimalMoves = neutralMoves = wastedMoves = 0;
+        efficiency = 0;
+        longestDetour = 0;
+        detourStart = -1;
+        firstMistake = -1;
+    }
+
+    // Phát lại các bước từ bàn ban đầu. Mỗi bước là chỉ số ô được trượt vào ô trống.
+    // Khoảng cách luôn đổi đúng 1 mỗi bước, nên bước "neutral" nghĩa là chưa xác định:
+    // trên bàn lớn, khi bộ giải đã dùng hết giới hạn nút thì các bước còn lại đều là neutral.
+    // Trả về false (và không giữ kết quả) nếu bàn không hợp lệ hoặc có bước không kề ô trống.
+    bool analyze(const int* startCells, const std::vector<int>& moves) {
+        reset();
+        if (!isPermutation(startCells)) return false;
+        int cells[CELL_COUNT];
+        memcpy(cells, startCells, sizeof(cells));
+        int empty = 0;
+        while (cells[empty] != EMPTY_CELL) empty++;
+
+#if BOARD_SIZE == 3
+        int distance = distanceToGoal(cells);
+#else
+        BoundedSolver solver; // Một giới hạn nút chung cho cả ván
+        int distance = solver.solve(cells);
+#endif
+        startDistance = distance;
+        int best = distance;
+        int currentDetourStart = -1;
+
+        for (size_t i = 0; i < moves.size(); i++) {
+            int next = moves[i];
+            if (next < 0 || next >= CELL_COUNT ||
+                abs(next / BOARD_SIZE - empty / BOARD_SIZE) + abs(next % BOARD_SIZE - empty % BOARD_SIZE) != 1) {
+                reset();
+                return false;
+            }
+            cells[empty] = cells[next];
+            cells[next] = EMPTY_CELL;
+            empty = next;
+            totalMoves++;
+
+#if BOARD_SIZE == 3
+            int newDistance = distanceToGoal(cells);
+#else
+            int newDistance = solver.solveNext(cells, distance);
+#endif
+            MoveLabel label = MOVE_NEUTRAL;
+            if (distance >= 0 && newDistance >= 0) {
+                label = newDistance < distance ? MOVE_OPTIMAL : MOVE_WASTED;
+            }
+            labels.push_back(label);
+            if (label == MOVE_OPTIMAL) optimalMoves++;
+            else if (label == MOVE_WASTED) wastedMoves++;
+            else neutralMoves++;
+
+            int moveNumber = (int)i + 1;
+            if (label == MOVE_WASTED && firstMistake == -1) {
+                firstMistake = moveNumber;
+            }
+
+            if (newDistance >= 0 && best >= 0) {
+                if (newDistance > best && currentDetourStart == -1) {
+                    currentDetourStart = moveNumber;
+                } else if (newDistance <= best) {
+                    if (currentDetourStart != -1) {
+                        int length = moveNumber - currentDetourStart + 1;
+                        if (length > longestDetour) {
+                            longestDetour = length;
+                            detourStart = currentDetourStart;
+                        }
+                        currentDetourStart = -1;
+                    }
+                    best = newDistance;
+                }
+            }
+            distance = newDistance;
+        }
+
+        if (totalMoves == 0) {
+            efficiency = 100;
+        } else if (startDistance >= 0) {
+            efficiency = startDistance * 100 / totalMoves;
+        }
+        return true;
+    }
+};
+
+// Thống kê gộp khi phân tích hàng loạt file nhật ký bước đi
+struct AnalysisStats {
+    int games;
+    int perfectGames;
+    long totalMoves, optimalMoves, neutralMoves, wastedMoves;
+    long optimalTotal; // Tổng số bước tối ưu của các ván
+    int longestDetour;
+
+    AnalysisStats() : games(0), perfectGames(0), totalMoves(0), optimalMoves(0),
+                      neutralMoves(0), wastedMoves(0), optimalTotal(0), longestDetour(0) {}
+
+    void add(const GameAnalysis& analysis) {
+        games++;
+        if (analysis.startDistance >= 0 && analysis.wastedMoves == 0 && analysis.neutralMoves == 0) perfectGames++;
+        totalMoves += analysis.totalMoves;
+        optimalMoves += analysis.optimalMoves;
+        neutralMoves += analysis.neutralMoves;
+        wastedMoves += analysis.wastedMoves;
+        if (analysis.startDistance > 0) optimalTotal += analysis.startDistance;
+        if (analysis.longestDetour > longestDetour) longestDetour = analysis.longestDetour;
+    }
+
+    int efficiency() const {
+        return totalMoves > 0 ? (int)(optimalTotal * 100 / totalMoves) : 100;
+    }
+};
+
+// Mỗi dòng: CELL_COUNT số của bàn ban đầu, số bước n, rồi n chỉ số ô
+inline bool parseMoveLogLine(const std::string& line, int* startCells, std::vector<int>& moves) {
+    std::istringstream in(line);
+    for (int i = 0; i < CELL_COUNT; i++) {
+        if (!(in >> startCells[i])) return false;
+    }
+    int count;
+    if (!(in >> count) || count < 0) return false;
+    moves.clear();
+    moves.reserve(count);
+    for (int i = 0; i < count; i++) {
+        int cell;
+        if (!(in >> cell)) return false;
+        moves.push_back(cell);
+    }
+    return true;
+}
+
+inline bool analyzeMoveLog(const char* path, AnalysisStats& stats) {
+    std::ifstream inFile(path);
+    if (!inFile.is_open()) return false;
+
+    std::string line;
+    int startCells[CELL_COUNT];
+    std::vector<int> moves;
+    GameAnalysis analysis;
+    while (std::getline(inFile, line)) {
+        if (!parseMoveLogLine(line, startCells, moves) || !analysis.analyze(startCells, moves)) continue;
+        stats.add(analysis);
+    }
+    return true;
+}
+
+#endif
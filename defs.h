@@ -12,13 +12,16 @@ const char* WINDOW_TITLE = "Sliding Puzzle";
 #define BOARD_X 75
 #define BOARD_Y 75
 #define EMPTY_CELL 0
+#define DRAG_THRESHOLD (CELL_SIZE / 3) // Khoảng kéo tối thiểu để tính là vuốt
 
 const char* FONT_PATH = "assets/Purisa-BoldOblique.ttf";
 const char* BACKGROUND_IMG = "assets/background.jpg";
 #define MENU_BACKGROUND_IMG "assets/menu_background.png"
+#define MOVE_LOG_PATH "movelog.txt"
+#define PACK_PATH "assets/puzzles.pack"
 
-const int MENU_OPTION_COUNT = 3;
-const char* MENU_OPTIONS[MENU_OPTION_COUNT] = {"Play", "Quit", "Sound"};
+const int MENU_OPTION_COUNT = 4;
+const char* MENU_OPTIONS[MENU_OPTION_COUNT] = {"Play", "Quit", "Sound", "Daily"};
 const int MENU_Y_START = 250;
 const int MENU_SPACING = 80;
 
@@ -5,8 +5,34 @@
 #include <SDL_image.h>
 #include <SDL_ttf.h>
 #include <SDL_mixer.h>
+#include <cstring>
 #include "defs.h"
 #include "logic.h"
+#include "resources.h"
+
+#define FONT_CACHE_SIZE 8
+
+// Vị trí của từng chữ trong bộ nhớ đệm; chữ chỉ được vẽ lại khi nội dung đổi
+enum TextSlot {
+    TEXT_MENU = 0,
+    TEXT_SOUND = TEXT_MENU + MENU_OPTION_COUNT,
+    TEXT_SOUND_BACK,
+    TEXT_MOVES,
+    TEXT_GIVE_UP,
+    TEXT_RESULT,
+    TEXT_BEST,
+    TEXT_BACK,
+    TEXT_ANALYSIS,
+    TEXT_CELL = TEXT_ANALYSIS + 3,
+    TEXT_SLOT_COUNT = TEXT_CELL + BOARD_SIZE * BOARD_SIZE
+};
+
+struct CachedText {
+    char text[64];
+    int fontSize;
+    SDL_Color color;
+    SDL_Texture* texture;
+};
 
 struct Graphics {
     SDL_Renderer *renderer;
@@ -18,6 +44,12 @@ struct Graphics {
     bool isMusicPlaying;
     bool showSoundSetting; // Trạng thái hiển thị trang Sound Setting
     int sliderValue; // Giá trị thanh trượt
+    SDL_Texture* backgroundTexture;
+    SDL_Texture* menuBackgroundTexture;
+    SDL_Texture* digitTextures[10]; // Chữ số cho "Moves: ", tạo sẵn để khung hình không phải tạo texture
+    TTF_Font* fontCache[FONT_CACHE_SIZE];
+    int fontCacheSizes[FONT_CACHE_SIZE];
+    CachedText textCache[TEXT_SLOT_COUNT];
 
     void logErrorAndExit(const char* msg, const char* error) {
         SDL_LogMessage(SDL_LOG_CATEGORY_APPLICATION, SDL_LOG_PRIORITY_ERROR, "%s: %s", msg, error);
@@ -26,6 +58,7 @@ struct Graphics {
     }
 
     void init() {
+        SDLAllocator::install(); // Phải gọi trước SDL_Init
         if (SDL_Init(SDL_INIT_EVERYTHING) != 0)
             logErrorAndExit("SDL_Init", SDL_GetError());
 
@@ -44,13 +77,14 @@ struct Graphics {
         if (TTF_Init() == -1)
             logErrorAndExit("SDL_ttf could not initialize!", TTF_GetError());
 
-        font = TTF_OpenFont(FONT_PATH, 50);
+        font = countedOpenFont(FONT_PATH, 50);
         if (font == nullptr)
             logErrorAndExit("Load font", TTF_GetError());
 
         if (Mix_OpenAudio(44100, MIX_DEFAULT_FORMAT, 2, 2048) < 0)
             logErrorAndExit("SDL_mixer could not initialize!", Mix_GetError());
 
+        resourceStats().count(RES_FILE_OPEN);
         backgroundMusic = Mix_LoadMUS(MUSIC_PATH);
         if (backgroundMusic == nullptr)
             logErrorAndExit("Failed to load music!", Mix_GetError());
@@ -78,6 +112,22 @@ struct Graphics {
                 }
             }
         }
+
+        for (int i = 0; i < FONT_CACHE_SIZE; i++) {
+            fontCache[i] = nullptr;
+            fontCacheSizes[i] = 0;
+        }
+        for (int i = 0; i < TEXT_SLOT_COUNT; i++) {
+            textCache[i].text[0] = '\0';
+            textCache[i].texture = nullptr;
+        }
+        backgroundTexture = loadTexture(BACKGROUND_IMG);
+        menuBackgroundTexture = loadTexture(MENU_BACKGROUND_IMG);
+        SDL_Color white = {255, 255, 255, 255};
+        for (int i = 0; i < 10; i++) {
+            char digit[2] = {(char)('0' + i), '\0'};
+            digitTextures[i] = renderText(digit, white);
+        }
     }
 
     void playMusic() {
@@ -94,33 +144,82 @@ struct Graphics {
     }
 
     SDL_Texture* loadTexture(const char* filename) {
-        SDL_Texture* texture = IMG_LoadTexture(renderer, filename);
+        SDL_Texture* texture = countedLoadTexture(renderer, filename);
         if (texture == NULL) {
             SDL_LogMessage(SDL_LOG_CATEGORY_APPLICATION, SDL_LOG_PRIORITY_ERROR, "Failed to load texture %s: %s", filename, IMG_GetError());
         }
         return texture;
     }
 
+    // Font theo cỡ chữ, mở một lần rồi giữ lại tới khi thoát
+    TTF_Font* getFont(int fontSize) {
+        if (fontSize == 50) return font;
+        for (int i = 0; i < FONT_CACHE_SIZE; i++) {
+            if (fontCacheSizes[i] == fontSize) return fontCache[i];
+            if (fontCacheSizes[i] == 0) {
+                fontCache[i] = countedOpenFont(FONT_PATH, fontSize);
+                if (fontCache[i] == nullptr) {
+                    SDL_LogMessage(SDL_LOG_CATEGORY_APPLICATION, SDL_LOG_PRIORITY_ERROR, "Failed to load font size %d: %s", fontSize, TTF_GetError());
+                    return nullptr;
+                }
+                fontCacheSizes[i] = fontSize;
+                return fontCache[i];
+            }
+        }
+        SDL_LogMessage(SDL_LOG_CATEGORY_APPLICATION, SDL_LOG_PRIORITY_ERROR, "Font cache full, cannot load size %d", fontSize);
+        return nullptr;
+    }
+
+    // Tạo texture mới cho chữ; người gọi phải hủy texture
     SDL_Texture* renderText(const char* text, SDL_Color textColor, int fontSize = 50) {
-        TTF_Font* tempFont = TTF_OpenFont(FONT_PATH, fontSize);
-        if (tempFont == nullptr) {
-            SDL_LogMessage(SDL_LOG_CATEGORY_APPLICATION, SDL_LOG_PRIORITY_ERROR, "Failed to load font size %d: %s", fontSize, TTF_GetError());
+        TTF_Font* textFont = getFont(fontSize);
+        if (textFont == nullptr) {
             return nullptr;
         }
-        SDL_Surface* textSurface = TTF_RenderText_Solid(tempFont, text, textColor);
-        TTF_CloseFont(tempFont);
+        SDL_Surface* textSurface = countedRenderText(textFont, text, textColor);
         if (textSurface == nullptr) {
             SDL_LogMessage(SDL_LOG_CATEGORY_APPLICATION, SDL_LOG_PRIORITY_ERROR, "Render text surface %s", TTF_GetError());
             return nullptr;
         }
-        SDL_Texture* texture = SDL_CreateTextureFromSurface(renderer, textSurface);
+        SDL_Texture* texture = countedCreateTexture(renderer, textSurface);
         if (texture == nullptr) {
             SDL_LogMessage(SDL_LOG_CATEGORY_APPLICATION, SDL_LOG_PRIORITY_ERROR, "Create text texture %s", SDL_GetError());
         }
-        SDL_FreeSurface(textSurface);
+        countedFreeSurface(textSurface);
         return texture;
     }
 
+    // Texture chữ thuộc bộ nhớ đệm, không được hủy; chỉ tạo lại khi chữ, cỡ hoặc màu đổi
+    SDL_Texture* cachedText(int slot, const char* text, SDL_Color textColor, int fontSize = 50) {
+        CachedText& cached = textCache[slot];
+        if (cached.texture != nullptr && cached.fontSize == fontSize && strcmp(cached.text, text) == 0 &&
+            cached.color.r == textColor.r && cached.color.g == textColor.g &&
+            cached.color.b == textColor.b && cached.color.a == textColor.a) {
+            return cached.texture;
+        }
+        countedDestroyTexture(cached.texture);
+        cached.texture = renderText(text, textColor, fontSize);
+        snprintf(cached.text, sizeof(cached.text), "%s", text);
+        cached.fontSize = fontSize;
+        cached.color = textColor;
+        return cached.texture;
+    }
+
+    // Vẽ số bằng các chữ số tạo sẵn, trả về hoành độ sau số
+    int renderNumber(int value, int x, int y) {
+        char digits[16];
+        sprintf(digits, "%d", value);
+        for (int i = 0; digits[i] != '\0'; i++) {
+            SDL_Texture* digit = digits[i] == '-' ? nullptr : digitTextures[digits[i] - '0'];
+            if (digit == nullptr) continue;
+            int digitW, digitH;
+            SDL_QueryTexture(digit, NULL, NULL, &digitW, &digitH);
+            renderTexture(digit, x, y);
+            x += digitW;
+        }
+        return x;
+    }
+
     void renderTexture(SDL_Texture* texture, int x, int y) {
         if (texture == nullptr) return;
         SDL_Rect dest;
@@ -134,11 +233,7 @@ struct Graphics {
         SDL_SetRenderDrawColor(renderer, 0, 0, 0, 255);
         SDL_RenderClear(renderer);
 
-        SDL_Texture* background = loadTexture(MENU_BACKGROUND_IMG);
-        if (background != nullptr) {
-            renderTexture(background, 0, 0);
-            SDL_DestroyTexture(background);
-        }
+        renderTexture(menuBackgroundTexture, 0, 0);
 
         SDL_Color white = {255, 255, 255, 255};
         for (int i = 0; i < MENU_OPTION_COUNT; i++) {
@@ -153,14 +248,13 @@ struct Graphics {
             SDL_RenderDrawRect(renderer, &rect);
 
             const char* text = MENU_OPTIONS[i];
-            SDL_Texture* textTexture = renderText(text, white);
+            SDL_Texture* textTexture = cachedText(TEXT_MENU + i, text, white);
             if (textTexture != nullptr) {
                 int textW, textH;
                 SDL_QueryTexture(textTexture, NULL, NULL, &textW, &textH);
                 int textX = rect.x + (rect.w - textW) / 2;
                 int textY = rect.y + (rect.h - textH) / 2;
                 renderTexture(textTexture, textX, textY);
-                SDL_DestroyTexture(textTexture);
             }
         }
 
@@ -186,14 +280,13 @@ struct Graphics {
         SDL_SetRenderDrawColor(renderer, 255, 255, 255, 255);
         SDL_RenderDrawRect(renderer, &soundButton);
         const char* soundText = isMusicPlaying ? "Sound: On" : "Sound: Off";
-        SDL_Texture* soundTextTexture = renderText(soundText, white, 30);
+        SDL_Texture* soundTextTexture = cachedText(TEXT_SOUND, soundText, white, 30);
         if (soundTextTexture != nullptr) {
             int textW, textH;
             SDL_QueryTexture(soundTextTexture, NULL, NULL, &textW, &textH);
             int textX = soundButton.x + (soundButton.w - textW) / 2;
             int textY = soundButton.y + (soundButton.h - textH) / 2;
             renderTexture(soundTextTexture, textX, textY);
-            SDL_DestroyTexture(soundTextTexture);
         }
 
         // Vẽ thanh trượt
@@ -214,28 +307,44 @@ struct Graphics {
         SDL_RenderFillRect(renderer, &backButton);
         SDL_SetRenderDrawColor(renderer, 255, 255, 255, 255);
         SDL_RenderDrawRect(renderer, &backButton);
-        SDL_Texture* backTextTexture = renderText("Back", white, 30);
+        SDL_Texture* backTextTexture = cachedText(TEXT_SOUND_BACK, "Back", white, 30);
         if (backTextTexture != nullptr) {
             int textW, textH;
             SDL_QueryTexture(backTextTexture, NULL, NULL, &textW, &textH);
             int textX = backButton.x + (backButton.w - textW) / 2;
             int textY = backButton.y + (backButton.h - textH) / 2;
             renderTexture(backTextTexture, textX, textY);
-            SDL_DestroyTexture(backTextTexture);
         }
 
         SDL_RenderPresent(renderer);
     }
 
+    // Hiển thị kết quả phân tích bước đi trên màn hình thắng
+    void renderAnalysis(const GameAnalysis& analysis, int y) {
+        SDL_Color white = {255, 255, 255, 255};
+        char lines[3][64];
+        sprintf(lines[0], "Efficiency: %d%% (%d/%d)", analysis.efficiency, analysis.startDistance, analysis.totalMoves);
+        sprintf(lines[1], "Optimal %d  Neutral %d  Wasted %d", analysis.optimalMoves, analysis.neutralMoves, analysis.wastedMoves);
+        if (analysis.firstMistake == -1) {
+            sprintf(lines[2], "Perfect game!");
+        } else {
+            sprintf(lines[2], "Detour: %d at #%d  First miss: #%d", analysis.longestDetour, analysis.detourStart, analysis.firstMistake);
+        }
+        for (int i = 0; i < 3; i++) {
+            SDL_Texture* lineTexture = cachedText(TEXT_ANALYSIS + i, lines[i], white, 20);
+            if (lineTexture != nullptr) {
+                int lineW, lineH;
+                SDL_QueryTexture(lineTexture, NULL, NULL, &lineW, &lineH);
+                renderTexture(lineTexture, SCREEN_WIDTH / 2 - lineW / 2, y + i * 30);
+            }
+        }
+    }
+
     void render(const SlidingPuzzle& game) {
         SDL_SetRenderDrawColor(renderer, 0, 0, 0, 255);
         SDL_RenderClear(renderer);
 
-        SDL_Texture* background = loadTexture(BACKGROUND_IMG);
-        if (background != nullptr) {
-            renderTexture(background, 0, 0);
-            SDL_DestroyTexture(background);
-        }
+        renderTexture(backgroundTexture, 0, 0);
 
         for (int i = 0; i < BOARD_SIZE; i++) {
             for (int j = 0; j < BOARD_SIZE; j++) {
@@ -254,14 +363,13 @@ struct Graphics {
                     char numberText[3];
                     sprintf(numberText, "%d", value);
                     SDL_Color white = {255, 255, 255, 255};
-                    SDL_Texture* numberTexture = renderText(numberText, white, 40);
+                    SDL_Texture* numberTexture = cachedText(TEXT_CELL + value, numberText, white, 40);
                     if (numberTexture != nullptr) {
                         int textW, textH;
                         SDL_QueryTexture(numberTexture, NULL, NULL, &textW, &textH);
                         int textX = x + (CELL_SIZE - textW) / 2;
                         int textY = y + (CELL_SIZE - textH) / 2;
                         renderTexture(numberTexture, textX, textY);
-                        SDL_DestroyTexture(numberTexture);
                     }
                 }
             }
@@ -270,12 +378,12 @@ struct Graphics {
         SDL_Color white = {255, 255, 255, 255};
         if (!game.isSolved()) {
             // Hiển thị số bước di chuyển
-            char moveText[50];
-            sprintf(moveText, "Moves: %d", game.moveCount);
-            SDL_Texture* textTexture = renderText(moveText, white);
+            SDL_Texture* textTexture = cachedText(TEXT_MOVES, "Moves: ", white);
             if (textTexture != nullptr) {
+                int textW, textH;
+                SDL_QueryTexture(textTexture, NULL, NULL, &textW, &textH);
                 renderTexture(textTexture, 10, 10);
-                SDL_DestroyTexture(textTexture);
+                renderNumber(game.moveCount, 10 + textW, 10);
             }
 
             // Vẽ nút Give Up
@@ -285,38 +393,35 @@ struct Graphics {
             SDL_SetRenderDrawColor(renderer, 255, 255, 255, 255);
             SDL_RenderDrawRect(renderer, &giveUpButton);
 
-            SDL_Texture* giveUpText = renderText("Give Up", white, 30);
+            SDL_Texture* giveUpText = cachedText(TEXT_GIVE_UP, "Give Up", white, 30);
             if (giveUpText != nullptr) {
                 int textW, textH;
                 SDL_QueryTexture(giveUpText, NULL, NULL, &textW, &textH);
                 int textX = giveUpButton.x + (giveUpButton.w - textW) / 2;
                 int textY = giveUpButton.y + (giveUpButton.h - textH) / 2;
                 renderTexture(giveUpText, textX, textY);
-                SDL_DestroyTexture(giveUpText);
             }
         } else {
             // Hiển thị thông báo khi game hoàn thành
             if (game.gaveUp) {
                 SDL_Color red = {255, 0, 0, 255};
-                SDL_Texture* loseText = renderText("You Lose!", red);
+                SDL_Texture* loseText = cachedText(TEXT_RESULT, "You Lose!", red);
                 if (loseText != nullptr) {
                     int loseTextW, loseTextH;
                     SDL_QueryTexture(loseText, NULL, NULL, &loseTextW, &loseTextH);
                     int loseX = SCREEN_WIDTH / 2 - loseTextW / 2;
                     int loseY = SCREEN_HEIGHT / 2 - loseTextH - 50;
                     renderTexture(loseText, loseX, loseY);
-                    SDL_DestroyTexture(loseText);
                 }
             } else {
                 SDL_Color yellow = {255, 255, 0, 255};
-                SDL_Texture* winText = renderText("You Win!", yellow);
+                SDL_Texture* winText = cachedText(TEXT_RESULT, "You Win!", yellow);
                 if (winText != nullptr) {
                     int winTextW, winTextH;
                     SDL_QueryTexture(winText, NULL, NULL, &winTextW, &winTextH);
                     int winX = SCREEN_WIDTH / 2 - winTextW / 2;
                     int winY = SCREEN_HEIGHT / 2 - winTextH - 50;
                     renderTexture(winText, winX, winY);
-                    SDL_DestroyTexture(winText);
                 }
             }
 
@@ -327,14 +432,17 @@ struct Graphics {
             } else {
                 sprintf(highScoreText, "Best: %d", game.highScore);
             }
-            SDL_Texture* highScoreTexture = renderText(highScoreText, white, 30);
+            SDL_Texture* highScoreTexture = cachedText(TEXT_BEST, highScoreText, white, 30);
             if (highScoreTexture != nullptr) {
                 int highScoreTextW, highScoreTextH;
                 SDL_QueryTexture(highScoreTexture, NULL, NULL, &highScoreTextW, &highScoreTextH);
                 int highScoreX = SCREEN_WIDTH / 2 - highScoreTextW / 2;
                 int highScoreY = SCREEN_HEIGHT / 2;
                 renderTexture(highScoreTexture, highScoreX, highScoreY);
-                SDL_DestroyTexture(highScoreTexture);
+            }
+
+            if (!game.gaveUp && game.analyzed) {
+                renderAnalysis(game.analysis, SCREEN_HEIGHT / 2 + 140);
             }
 
             // Vẽ nút Back
@@ -344,14 +452,13 @@ struct Graphics {
             SDL_SetRenderDrawColor(renderer, 255, 255, 255, 255);
             SDL_RenderDrawRect(renderer, &backButton);
 
-            SDL_Texture* backText = renderText("Back", white, 30);
+            SDL_Texture* backText = cachedText(TEXT_BACK, "Back", white, 30);
             if (backText != nullptr) {
                 int backTextW, backTextH;
                 SDL_QueryTexture(backText, NULL, NULL, &backTextW, &backTextH);
                 int backX = backButton.x + (backButton.w - backTextW) / 2;
                 int backY = backButton.y + (backButton.h - backTextH) / 2;
                 renderTexture(backText, backX, backY);
-                SDL_DestroyTexture(backText);
             }
         }
 
@@ -365,11 +472,23 @@ struct Graphics {
         Mix_CloseAudio();
         for (int i = 0; i < BOARD_SIZE * BOARD_SIZE; i++) {
             if (cellTextures[i] != nullptr) {
-                SDL_DestroyTexture(cellTextures[i]);
+                countedDestroyTexture(cellTextures[i]);
                 cellTextures[i] = nullptr;
             }
         }
-        TTF_CloseFont(font);
+        for (int i = 0; i < TEXT_SLOT_COUNT; i++) {
+            countedDestroyTexture(textCache[i].texture);
+            textCache[i].texture = nullptr;
+        }
+        for (int i = 0; i < 10; i++) {
+            countedDestroyTexture(digitTextures[i]);
+        }
+        countedDestroyTexture(backgroundTexture);
+        countedDestroyTexture(menuBackgroundTexture);
+        for (int i = 0; i < FONT_CACHE_SIZE; i++) {
+            countedCloseFont(fontCache[i]);
+        }
+        countedCloseFont(font);
         TTF_Quit();
         IMG_Quit();
         SDL_DestroyRenderer(renderer);
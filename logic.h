@@ -2,9 +2,13 @@
 #define _LOGIC__H
 
 #include <cstdlib>
+#include <cstring>
 #include <ctime>
 #include <fstream>
+#include <vector>
 #include "defs.h"
+#include "analysis.h"
+#include "pack.h"
 
 struct SlidingPuzzle {
     int board[BOARD_SIZE][BOARD_SIZE];
@@ -12,13 +16,23 @@ struct SlidingPuzzle {
     int moveCount;
     int highScore;
     bool gaveUp;
+    int startBoard[BOARD_SIZE][BOARD_SIZE]; // Bàn ban đầu, dùng để phát lại khi phân tích
+    std::vector<int> moveLog; // Chỉ số ô đã trượt vào ô trống ở mỗi bước
+    GameAnalysis analysis;
+    bool analyzed;
+    int fileOpens; // Số lần mở file chưa được main.cpp cộng vào thống kê tài nguyên
 
-    SlidingPuzzle() : moveCount(0), highScore(-1), gaveUp(false) {
+    SlidingPuzzle() : moveCount(0), highScore(-1), gaveUp(false), analyzed(false), fileOpens(0) {
+        moveLog.reserve(1024); // Tránh cấp phát khi đang chơi
         loadHighScore();
         init();
+#if BOARD_SIZE == 3
+        getDistanceTable().build(); // Dựng sẵn để màn hình thắng hiện phân tích ngay
+#endif
     }
 
     void loadHighScore() {
+        fileOpens++;
         std::ifstream inFile("highscore.txt");
         if (inFile.is_open()) {
             inFile >> highScore;
@@ -31,6 +45,7 @@ struct SlidingPuzzle {
     }
 
     void saveHighScore() {
+        fileOpens++;
         std::ofstream outFile("highscore.txt");
         if (outFile.is_open()) {
             outFile << highScore;
@@ -42,14 +57,11 @@ struct SlidingPuzzle {
     }
 
     int getInversions() {
+        return getInversions(&board[0][0]);
+    }
+
+    static int getInversions(const int* flat) {
         int inversions = 0;
-        int flat[BOARD_SIZE * BOARD_SIZE];
-        int k = 0;
-        for (int i = 0; i < BOARD_SIZE; i++) {
-            for (int j = 0; j < BOARD_SIZE; j++) {
-                flat[k++] = board[i][j];
-            }
-        }
         for (int i = 0; i < BOARD_SIZE * BOARD_SIZE - 1; i++) {
             for (int j = i + 1; j < BOARD_SIZE * BOARD_SIZE; j++) {
                 if (flat[i] != EMPTY_CELL && flat[j] != EMPTY_CELL && flat[i] > flat[j]) {
@@ -65,6 +77,10 @@ struct SlidingPuzzle {
         return (inversions % 2 == 0);
     }
 
+    static bool isSolvable(const int* cells) {
+        return getInversions(cells) % 2 == 0;
+    }
+
     void init() {
         moveCount = 0;
         gaveUp = false;
@@ -97,18 +113,94 @@ struct SlidingPuzzle {
             }
         } while (!isSolvable());
 
+        memcpy(startBoard, board, sizeof(board));
+        moveLog.clear();
+        analyzed = false;
+
         SDL_LogMessage(SDL_LOG_CATEGORY_APPLICATION, SDL_LOG_PRIORITY_INFO, "Board initialized successfully.");
     }
 
+    // Bắt đầu ván với bàn cho sẵn (ví dụ đề từ gói đề); từ chối bàn không giải được
+    bool loadBoard(const int* cells) {
+        if (!isPermutation(cells) || !isSolvable(cells)) return false;
+
+        moveCount = 0;
+        gaveUp = false;
+        loadHighScore();
+        for (int i = 0; i < BOARD_SIZE; i++) {
+            for (int j = 0; j < BOARD_SIZE; j++) {
+                board[i][j] = cells[i * BOARD_SIZE + j];
+                if (board[i][j] == EMPTY_CELL) {
+                    emptyRow = i;
+                    emptyCol = j;
+                }
+            }
+        }
+        memcpy(startBoard, board, sizeof(board));
+        moveLog.clear();
+        analyzed = false;
+        return true;
+    }
+
+    // Đề số n trong gói đề
+    bool loadFromPack(const PuzzlePack& pack, uint32_t n) {
+        int cells[BOARD_SIZE * BOARD_SIZE];
+        if (!pack.getBoard(n, cells) || !loadBoard(cells)) {
+            SDL_LogMessage(SDL_LOG_CATEGORY_APPLICATION, SDL_LOG_PRIORITY_ERROR, "Failed to load puzzle #%u from pack", n);
+            return false;
+        }
+        SDL_LogMessage(SDL_LOG_CATEGORY_APPLICATION, SDL_LOG_PRIORITY_INFO, "Loaded puzzle #%u from pack", n);
+        return true;
+    }
+
+    // Đề của ngày `day` (số ngày kể từ 1970-01-01)
+    bool loadDaily(const PuzzlePack& pack, int day) {
+        long n = pack.findByDate(day, PACK_DAILY);
+        if (n < 0) {
+            SDL_LogMessage(SDL_LOG_CATEGORY_APPLICATION, SDL_LOG_PRIORITY_INFO, "No daily puzzle for day %d", day);
+            return false;
+        }
+        return loadFromPack(pack, (uint32_t)n);
+    }
+
+    // Trượt một ô kề ô trống vào ô trống, không kiểm tra và không ghi log
+    void step(int row, int col) {
+        board[emptyRow][emptyCol] = board[row][col];
+        board[row][col] = EMPTY_CELL;
+        emptyRow = row;
+        emptyCol = col;
+        moveCount++;
+        moveLog.push_back(row * BOARD_SIZE + col);
+    }
+
+    // Log mỗi bước chỉ khi bật mức DEBUG, tránh tốn chi phí cho người chơi nhanh
+    void logMove(int tiles) {
+        if (SDL_LogGetPriority(SDL_LOG_CATEGORY_APPLICATION) <= SDL_LOG_PRIORITY_DEBUG) {
+            SDL_LogMessage(SDL_LOG_CATEGORY_APPLICATION, SDL_LOG_PRIORITY_DEBUG, "Moved %d tile(s), moveCount: %d", tiles, moveCount);
+        }
+    }
+
     void move(int row, int col) {
         if (abs(row - emptyRow) + abs(col - emptyCol) == 1) {
-            board[emptyRow][emptyCol] = board[row][col];
-            board[row][col] = EMPTY_CELL;
-            emptyRow = row;
-            emptyCol = col;
-            moveCount++;
-            SDL_LogMessage(SDL_LOG_CATEGORY_APPLICATION, SDL_LOG_PRIORITY_INFO, "Move made, moveCount: %d", moveCount);
+            step(row, col);
+            logMove(1);
+        }
+    }
+
+    // Trượt cả dãy ô từ (row, col) tới ô trống nếu cùng hàng hoặc cùng cột.
+    // Mỗi ô được đẩy tính là một bước. Trả về số ô đã trượt.
+    int slide(int row, int col) {
+        if (row < 0 || row >= BOARD_SIZE || col < 0 || col >= BOARD_SIZE) return 0;
+        if ((row == emptyRow) == (col == emptyCol)) return 0;
+
+        int tiles = abs(row - emptyRow) + abs(col - emptyCol);
+        int dRow = (row > emptyRow) - (row < emptyRow);
+        int dCol = (col > emptyCol) - (col < emptyCol);
+        for (int i = 0; i < tiles; i++) {
+            step(emptyRow + dRow, emptyCol + dCol);
         }
+        logMove(tiles);
+        return tiles;
     }
 
     void giveUp() {
@@ -140,6 +232,35 @@ struct SlidingPuzzle {
         }
     }
 
+    // Phân tích các bước đã đi khi thắng và ghi lại vào nhật ký
+    void analyzeGame() {
+        if (analyzed) return;
+        analysis.analyze(&startBoard[0][0], moveLog);
+        analyzed = true;
+        saveMoveLog();
+        SDL_LogMessage(SDL_LOG_CATEGORY_APPLICATION, SDL_LOG_PRIORITY_INFO, "Game analyzed, efficiency: %d%%", analysis.efficiency);
+    }
+
+    void saveMoveLog() {
+        fileOpens++;
+        std::ofstream outFile(MOVE_LOG_PATH, std::ios::app);
+        if (outFile.is_open()) {
+            for (int i = 0; i < BOARD_SIZE; i++) {
+                for (int j = 0; j < BOARD_SIZE; j++) {
+                    outFile << startBoard[i][j] << ' ';
+                }
+            }
+            outFile << moveLog.size();
+            for (size_t i = 0; i < moveLog.size(); i++) {
+                outFile << ' ' << moveLog[i];
+            }
+            outFile << '\n';
+            outFile.close();
+        } else {
+            SDL_LogMessage(SDL_LOG_CATEGORY_APPLICATION, SDL_LOG_PRIORITY_ERROR, "Failed to save move log to file");
+        }
+    }
+
     bool isSolved() const {
         int expected[BOARD_SIZE][BOARD_SIZE] = {
             {1, 2, 3},
@@ -1,56 +1,98 @@
 #include <iostream>
+#include <cstring>
 #include <SDL.h>
 #include "defs.h"
 #include "graphics.h"
 #include "logic.h"
+#include "analysis.h"
+#include "pack.h"
+#include "resources.h"
 
 using namespace std;
 
 enum GameState { MENU, PLAYING, SOUND_SETTING };
-void processClick(int x, int y, SlidingPuzzle& game, Graphics& graphics, GameState& state);
-void handleMenuInput(SDL_Event& event, int& selectedOption, GameState& state, SlidingPuzzle& game, Graphics& graphics, bool& quit);
+
+// Trạng thái chuột khi chơi: click và vuốt được xử lý lúc nhả chuột
+struct PlayInput {
+    bool mouseDown;
+    int pressX, pressY;
+};
+
+void processClick(int x, int y, SlidingPuzzle& game, GameState& state);
+void slideToward(int dRow, int dCol, SlidingPuzzle& game);
+void dragTile(int x, int y, int dRow, int dCol, SlidingPuzzle& game);
+void finishIfSolved(SlidingPuzzle& game);
+void handlePlayingInput(SDL_Event& event, PlayInput& input, SlidingPuzzle& game, GameState& state, bool& quit, bool& needsRedraw);
+void handleMenuInput(SDL_Event& event, int& selectedOption, GameState& state, SlidingPuzzle& game, Graphics& graphics, const PuzzlePack& pack, bool& quit);
 
 int main(int argc, char* argv[]) {
+    // Phân tích hàng loạt nhật ký bước đi: SDL --analyze movelog.txt
+    if (argc >= 3 && strcmp(argv[1], "--analyze") == 0) {
+        AnalysisStats stats;
+        if (!analyzeMoveLog(argv[2], stats)) {
+            cerr << "Cannot open move log " << argv[2] << endl;
+            return 1;
+        }
+        cout << "Games: " << stats.games << " (perfect " << stats.perfectGames << ")" << endl;
+        cout << "Moves: " << stats.totalMoves << " optimal " << stats.optimalMoves
+             << " neutral " << stats.neutralMoves << " wasted " << stats.wastedMoves << endl;
+        cout << "Efficiency: " << stats.efficiency() << "%" << endl;
+        cout << "Longest detour: " << stats.longestDetour << endl;
+        return 0;
+    }
+
     Graphics graphics;
     graphics.init();
 
     SlidingPuzzle game;
 
+    // Gói đề là tùy chọn; chỉ ánh xạ file, không đọc nội dung
+    PuzzlePack pack;
+    resourceStats().count(RES_FILE_OPEN);
+    if (pack.open(PACK_PATH)) {
+        SDL_LogMessage(SDL_LOG_CATEGORY_APPLICATION, SDL_LOG_PRIORITY_INFO, "Opened puzzle pack with %u boards", pack.boardCount());
+    }
+
+    // Ngân sách cho mỗi khung hình ổn định (không tính khung chuyển màn hình hay ván mới)
+    ResourceStats& stats = resourceStats();
+    const GameState steadyScreens[] = {MENU, PLAYING};
+    for (int i = 0; i < 2; i++) {
+        stats.setBudget(steadyScreens[i], RES_TEXTURE_CREATE, 0);
+        stats.setBudget(steadyScreens[i], RES_SURFACE_CREATE, 0);
+        stats.setBudget(steadyScreens[i], RES_FONT_OPEN, 0);
+        stats.setBudget(steadyScreens[i], RES_FILE_OPEN, 0);
+    }
+    stats.setBudget(MENU, RES_HEAP_ALLOC, 0);
+    stats.setBudget(PLAYING, RES_HEAP_ALLOC, 0);
+    stats.setBudget(SOUND_SETTING, RES_FONT_OPEN, 0); // Chữ Sound On/Off được tạo lại khi bật/tắt
+    stats.setBudget(SOUND_SETTING, RES_FILE_OPEN, 0);
+
     GameState state = MENU;
     int selectedOption = 0;
     bool quit = false;
+    bool needsRedraw = true;
+    PlayInput input = {false, 0, 0};
     SDL_Event event;
 
     while (!quit) {
+        // Gom mọi sự kiện trong một lượt: nhiều bước đi chỉ cập nhật và vẽ lại một lần
+        GameState prevState = state;
+        bool prevSolved = game.isSolved();
+        size_t prevLogCapacity = game.moveLog.capacity();
+        stats.beginFrame();
         while (SDL_PollEvent(&event)) {
             switch (state) {
                 case MENU:
-                    handleMenuInput(event, selectedOption, state, game, graphics, quit);
+                    handleMenuInput(event, selectedOption, state, game, graphics, pack, quit);
                     break;
                 case PLAYING:
-                    if (event.type == SDL_QUIT) {
-                        quit = true;
-                    } else if (event.type == SDL_MOUSEBUTTONDOWN) {
-                        int x, y;
-                        SDL_GetMouseState(&x, &y);
-                        processClick(x, y, game, graphics, state);
-                    } else if (event.type == SDL_KEYDOWN) {
-                        if (event.key.keysym.sym == SDLK_r) {
-                            game.init();
-                        } else if (event.key.keysym.sym == SDLK_m) {
-                            state = MENU;
-                        }
-                    }
-                    if (game.isSolved() && !game.gaveUp) { // Chỉ cập nhật highScore nếu không Give Up
-                        game.updateHighScore();
-                    }
+                    handlePlayingInput(event, input, game, state, quit, needsRedraw);
                     break;
                 case SOUND_SETTING:
                     if (event.type == SDL_QUIT) {
                         quit = true;
                     } else if (event.type == SDL_MOUSEBUTTONDOWN) {
-                        int x, y;
-                        SDL_GetMouseState(&x, &y);
+                        int x = event.button.x, y = event.button.y;
                         // Kiểm tra nút Sound On/Off
                         SDL_Rect soundButton = {SOUND_SETTING_X + 125, SOUND_SETTING_Y + 50, BUTTON_WIDTH, BUTTON_HEIGHT};
                         if (x >= soundButton.x && x <= soundButton.x + soundButton.w &&
@@ -84,20 +126,39 @@ int main(int argc, char* argv[]) {
             }
         }
 
+        if (state != prevState) {
+            needsRedraw = true;
+            input.mouseDown = false;
+        }
+
         if (state == MENU) {
             graphics.renderMenu(selectedOption, game.moveCount, game.highScore);
         } else if (state == PLAYING) {
-            graphics.render(game);
+            if (needsRedraw) {
+                graphics.render(game);
+                needsRedraw = false;
+            } else {
+                SDL_WaitEventTimeout(NULL, 16); // Không có gì thay đổi, chờ sự kiện tiếp theo
+            }
         } else if (state == SOUND_SETTING) {
             graphics.renderSoundSetting();
         }
+
+        // Nhật ký bước đi nới rộng (ván rất dài) là cấp phát hợp lệ, không phải lỗi vẽ lại
+        if (state != prevState || game.isSolved() != prevSolved || game.moveLog.capacity() != prevLogCapacity) {
+            stats.markTransition();
+        }
+        stats.count(RES_FILE_OPEN, game.fileOpens);
+        game.fileOpens = 0;
+        stats.endFrame(state);
     }
 
     graphics.quit();
+    stats.logTotals();
     return 0;
 }
 
-void processClick(int x, int y, SlidingPuzzle& game, Graphics& graphics, GameState& state) {
+void processClick(int x, int y, SlidingPuzzle& game, GameState& state) {
     if (!game.isSolved()) {
         // Kiểm tra nhấn nút Give Up
         SDL_Rect giveUpButton = {SCREEN_WIDTH - 210, SCREEN_HEIGHT - 60, 200, 50};
@@ -105,16 +166,16 @@ void processClick(int x, int y, SlidingPuzzle& game, Graphics& graphics, GameSta
             y >= giveUpButton.y && y <= giveUpButton.y + giveUpButton.h) {
             SDL_LogMessage(SDL_LOG_CATEGORY_APPLICATION, SDL_LOG_PRIORITY_INFO, "Give Up clicked at (%d, %d)", x, y);
             game.giveUp();
-            graphics.render(game);
             return;
         }
 
-        // Kiểm tra nhấn ô trên bàn cờ
+        // Kiểm tra nhấn ô trên bàn cờ: trượt cả dãy ô về phía ô trống
+        if (x < BOARD_X || y < BOARD_Y) return;
         int clickedCol = (x - BOARD_X) / CELL_SIZE;
         int clickedRow = (y - BOARD_Y) / CELL_SIZE;
-        if (clickedRow >= 0 && clickedRow < BOARD_SIZE && clickedCol >= 0 && clickedCol < BOARD_SIZE) {
-            game.move(clickedRow, clickedCol);
-            graphics.render(game);
+        if (clickedRow < BOARD_SIZE && clickedCol < BOARD_SIZE) {
+            game.slide(clickedRow, clickedCol);
+            finishIfSolved(game);
         }
     } else {
         // Kiểm tra nhấn nút Back
@@ -123,14 +184,106 @@ void processClick(int x, int y, SlidingPuzzle& game, Graphics& graphics, GameSta
             y >= backButton.y && y <= backButton.y + backButton.h) {
             SDL_LogMessage(SDL_LOG_CATEGORY_APPLICATION, SDL_LOG_PRIORITY_INFO, "Back clicked at (%d, %d)", x, y);
             state = MENU;
+            resourceStats().markTransition();
             game.init();
             game.resetMoves();
-            graphics.renderMenu(0, game.moveCount, game.highScore);
         }
     }
 }
 
-void handleMenuInput(SDL_Event& event, int& selectedOption, GameState& state, SlidingPuzzle& game, Graphics& graphics, bool& quit) {
+// Đẩy ô cạnh ô trống theo hướng (dRow, dCol) vào ô trống
+void slideToward(int dRow, int dCol, SlidingPuzzle& game) {
+    if (game.isSolved()) return;
+    if (game.slide(game.emptyRow - dRow, game.emptyCol - dCol) > 0) {
+        finishIfSolved(game);
+    }
+}
+
+// Vuốt bắt đầu tại (x, y): chỉ trượt dãy ô từ ô được nhấn tới ô trống khi ô đó
+// cùng hàng hoặc cùng cột với ô trống và hướng vuốt chỉ về phía ô trống
+void dragTile(int x, int y, int dRow, int dCol, SlidingPuzzle& game) {
+    if (game.isSolved() || x < BOARD_X || y < BOARD_Y) return;
+    int col = (x - BOARD_X) / CELL_SIZE;
+    int row = (y - BOARD_Y) / CELL_SIZE;
+    if (row >= BOARD_SIZE || col >= BOARD_SIZE) return;
+    int towardRow = (game.emptyRow > row) - (game.emptyRow < row);
+    int towardCol = (game.emptyCol > col) - (game.emptyCol < col);
+    if (towardRow != dRow || towardCol != dCol) return;
+    if (game.slide(row, col) > 0) {
+        finishIfSolved(game);
+    }
+}
+
+// Ghi kỷ lục và phân tích ngay sau bước thắng, trước khi sự kiện tiếp theo
+// trong cùng lượt (R, M, Back) kịp bắt đầu ván mới
+void finishIfSolved(SlidingPuzzle& game) {
+    if (game.isSolved() && !game.gaveUp) { // Chỉ cập nhật highScore nếu không Give Up
+        game.updateHighScore();
+        game.analyzeGame();
+    }
+}
+
+void handlePlayingInput(SDL_Event& event, PlayInput& input, SlidingPuzzle& game, GameState& state, bool& quit, bool& needsRedraw) {
+    switch (event.type) {
+        case SDL_QUIT:
+            quit = true;
+            break;
+        case SDL_MOUSEBUTTONDOWN:
+            if (event.button.button == SDL_BUTTON_LEFT) {
+                input.mouseDown = true;
+                input.pressX = event.button.x;
+                input.pressY = event.button.y;
+            }
+            break;
+        case SDL_MOUSEBUTTONUP:
+            if (event.button.button == SDL_BUTTON_LEFT && input.mouseDown) {
+                input.mouseDown = false;
+                int dx = event.button.x - input.pressX;
+                int dy = event.button.y - input.pressY;
+                if (abs(dx) < DRAG_THRESHOLD && abs(dy) < DRAG_THRESHOLD) {
+                    processClick(input.pressX, input.pressY, game, state);
+                } else if (abs(dx) >= abs(dy)) { // Vuốt ngang
+                    dragTile(input.pressX, input.pressY, 0, dx > 0 ? 1 : -1, game);
+                } else { // Vuốt dọc
+                    dragTile(input.pressX, input.pressY, dy > 0 ? 1 : -1, 0, game);
+                }
+            }
+            break;
+        case SDL_MOUSEMOTION:
+            return; // Di chuột không làm thay đổi màn hình
+        case SDL_KEYDOWN:
+            switch (event.key.keysym.sym) {
+                case SDLK_r:
+                    resourceStats().markTransition(); // Ván mới đọc lại file kỷ lục, không phải khung hình ổn định
+                    game.init();
+                    break;
+                case SDLK_m:
+                    state = MENU;
+                    break;
+                // Phím hướng: ô cạnh ô trống trượt theo hướng đã nhấn
+                case SDLK_UP:
+                case SDLK_w:
+                    slideToward(-1, 0, game);
+                    break;
+                case SDLK_DOWN:
+                case SDLK_s:
+                    slideToward(1, 0, game);
+                    break;
+                case SDLK_LEFT:
+                case SDLK_a:
+                    slideToward(0, -1, game);
+                    break;
+                case SDLK_RIGHT:
+                case SDLK_d:
+                    slideToward(0, 1, game);
+                    break;
+            }
+            break;
+    }
+    needsRedraw = true;
+}
+
+void handleMenuInput(SDL_Event& event, int& selectedOption, GameState& state, SlidingPuzzle& game, Graphics& graphics, const PuzzlePack& pack, bool& quit) {
     switch (event.type) {
         case SDL_QUIT:
             quit = true;
@@ -144,6 +297,7 @@ void handleMenuInput(SDL_Event& event, int& selectedOption, GameState& state, Sl
                 if (selectedOption == 0) { // Play
                     graphics.showSoundSetting = false;
                     state = PLAYING;
+                    resourceStats().markTransition();
                     game.init();
                     game.resetMoves();
                 } else if (selectedOption == 1) { // Quit
@@ -152,12 +306,21 @@ void handleMenuInput(SDL_Event& event, int& selectedOption, GameState& state, Sl
                     graphics.showSoundSetting = true;
                     state = SOUND_SETTING;
                     graphics.renderSoundSetting();
+                } else if (selectedOption == 3) { // Daily
+                    graphics.showSoundSetting = false;
+                    state = PLAYING;
+                    resourceStats().markTransition();
+                    if (!pack.isOpen() || !game.loadDaily(pack, today())) {
+                        game.init(); // Không có đề hôm nay thì chơi bàn ngẫu nhiên
+                    }
+                    game.resetMoves();
                 }
             }
             break;
         case SDL_MOUSEBUTTONDOWN:
             int mouseX, mouseY;
-            SDL_GetMouseState(&mouseX, &mouseY);
+            mouseX = event.button.x;
+            mouseY = event.button.y;
             for (int i = 0; i < MENU_OPTION_COUNT; i++) {
                 SDL_Rect rect = {(SCREEN_WIDTH - 200) / 2, MENU_Y_START + i * MENU_SPACING, 200, 50};
                 if (mouseX >= rect.x && mouseX <= rect.x + rect.w &&
@@ -166,6 +329,7 @@ void handleMenuInput(SDL_Event& event, int& selectedOption, GameState& state, Sl
                     if (selectedOption == 0) { // Play
                         graphics.showSoundSetting = false;
                         state = PLAYING;
+                        resourceStats().markTransition();
                         game.init();
                         game.resetMoves();
                     } else if (selectedOption == 1) { // Quit
@@ -174,6 +338,14 @@ void handleMenuInput(SDL_Event& event, int& selectedOption, GameState& state, Sl
                         graphics.showSoundSetting = true;
                         state = SOUND_SETTING;
                         graphics.renderSoundSetting();
+                    } else if (selectedOption == 3) { // Daily
+                        graphics.showSoundSetting = false;
+                        state = PLAYING;
+                        resourceStats().markTransition();
+                        if (!pack.isOpen() || !game.loadDaily(pack, today())) {
+                            game.init(); // Không có đề hôm nay thì chơi bàn ngẫu nhiên
+                        }
+                        game.resetMoves();
                     }
                     break;
                 }
@@ -0,0 +1,244 @@
+#ifndef _PACK__H
+#define _PACK__H
+
+#include <cstring>
+#include <ctime>
+#include <stdint.h>
+#include "defs.h"
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+// Định dạng gói đề (little-endian):
+//   PackHeader | PackIndexEntry[indexCount] (sắp theo kind, day) | PackBoard[boardCount]
+// Mọi bản ghi có kích thước cố định nên tra "đề số N" hay "đề ngày D" không cần đọc cả file.
+// Vị trí mỗi bảng là bội số kích thước bản ghi của nó (có đệm 0 nếu cần).
+#define PACK_MAGIC "SPPK"
+#define PACK_VERSION 2
+
+enum PackKind { PACK_DAILY = 0, PACK_WEEKLY = 1 };
+
+// Các trường tùy chọn của một đề
+#define PACK_HAS_SEED 1
+#define PACK_HAS_PAR 2
+#define PACK_HAS_BAND 4
+
+struct PackHeader {
+    char magic[4];
+    uint16_t version;
+    uint8_t boardSize;
+    uint8_t reserved;
+    uint32_t boardCount;
+    uint32_t indexCount;
+    uint64_t indexOffset;
+    uint64_t boardsOffset;
+};
+
+struct PackIndexEntry {
+    int32_t day;    // Số ngày kể từ 1970-01-01 (ngày đầu tuần với đề tuần)
+    uint16_t kind;
+    uint16_t reserved;
+    uint32_t board;
+};
+
+struct PackBoard {
+    uint64_t cells; // 4 bit mỗi ô, ô 0 ở bit thấp nhất
+    uint32_t seed;
+    uint8_t par;    // Số bước tối ưu
+    uint8_t band;   // Mức độ khó
+    uint8_t flags;
+    uint8_t reserved;
+};
+
+static_assert(sizeof(PackHeader) == 32, "PackHeader layout");
+static_assert(sizeof(PackIndexEntry) == 12, "PackIndexEntry layout");
+static_assert(sizeof(PackBoard) == 16, "PackBoard layout");
+static_assert(BOARD_SIZE * BOARD_SIZE <= 16, "PackBoard stores at most 16 cells");
+
+// Làm tròn lên bội số của `record`
+inline uint64_t alignOffset(uint64_t offset, uint64_t record) {
+    return (offset + record - 1) / record * record;
+}
+
+// Bảng `count` bản ghi tại `offset` phải nằm trọn trong file; so sánh theo cách không bị tràn số
+inline bool tableFits(uint64_t offset, uint64_t count, uint64_t record, uint64_t size) {
+    return offset <= size && offset % record == 0 && count <= (size - offset) / record;
+}
+
+inline uint64_t packCells(const int* cells) {
+    uint64_t packed = 0;
+    for (int i = 0; i < BOARD_SIZE * BOARD_SIZE; i++) {
+        packed |= (uint64_t)(cells[i] & 0xF) << (4 * i);
+    }
+    return packed;
+}
+
+inline void unpackCells(uint64_t packed, int* cells) {
+    for (int i = 0; i < BOARD_SIZE * BOARD_SIZE; i++) {
+        cells[i] = (int)((packed >> (4 * i)) & 0xF);
+    }
+}
+
+// Số ngày kể từ 1970-01-01 theo lịch Gregory
+inline int daysFromCivil(int year, int month, int day) {
+    year -= month <= 2;
+    int era = (year >= 0 ? year : year - 399) / 400;
+    int yoe = year - era * 400;
+    int doy = (153 * (month + (month > 2 ? -3 : 9)) + 2) / 5 + day - 1;
+    int doe = yoe * 365 + yoe / 4 - yoe / 100 + doy;
+    return era * 146097 + doe - 719468;
+}
+
+inline int today() {
+    time_t now = time(0);
+    tm* local = localtime(&now);
+    return daysFromCivil(local->tm_year + 1900, local->tm_mon + 1, local->tm_mday);
+}
+
+// Ngày thứ Hai của tuần chứa `day` (1970-01-01 là thứ Năm)
+inline int weekStart(int day) {
+    return day - ((day + 3) % 7 + 7) % 7;
+}
+
+// Gói đề được ánh xạ vào bộ nhớ, chỉ đọc. Mở file chỉ kiểm tra header nên
+// không phụ thuộc kích thước gói.
+struct PuzzlePack {
+    const unsigned char* data;
+    size_t size;
+    const PackHeader* header;
+    const PackIndexEntry* index;
+    const PackBoard* boards;
+#ifdef _WIN32
+    HANDLE file;
+    HANDLE mapping;
+#else
+    int fd;
+#endif
+
+    PuzzlePack() : data(nullptr), size(0), header(nullptr), index(nullptr), boards(nullptr) {
+#ifdef _WIN32
+        file = INVALID_HANDLE_VALUE;
+        mapping = nullptr;
+#else
+        fd = -1;
+#endif
+    }
+
+    ~PuzzlePack() {
+        close();
+    }
+
+    bool isOpen() const {
+        return header != nullptr;
+    }
+
+    bool open(const char* path) {
+        close();
+#ifdef _WIN32
+        file = CreateFileA(path, GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+        if (file == INVALID_HANDLE_VALUE) return false;
+        LARGE_INTEGER fileSize;
+        if (!GetFileSizeEx(file, &fileSize) || fileSize.QuadPart < (LONGLONG)sizeof(PackHeader)) {
+            close();
+            return false;
+        }
+        size = (size_t)fileSize.QuadPart;
+        mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+        if (mapping == nullptr) {
+            close();
+            return false;
+        }
+        data = (const unsigned char*)MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+        if (data == nullptr) {
+            close();
+            return false;
+        }
+#else
+        fd = ::open(path, O_RDONLY);
+        if (fd < 0) return false;
+        struct stat st;
+        if (fstat(fd, &st) != 0 || st.st_size < (off_t)sizeof(PackHeader)) {
+            close();
+            return false;
+        }
+        size = (size_t)st.st_size;
+        void* mapped = mmap(nullptr, size, PROT_READ, MAP_SHARED, fd, 0);
+        if (mapped == MAP_FAILED) {
+            close();
+            return false;
+        }
+        data = (const unsigned char*)mapped;
+#endif
+        const PackHeader* h = (const PackHeader*)data;
+        if (memcmp(h->magic, PACK_MAGIC, 4) != 0 || h->version != PACK_VERSION || h->boardSize != BOARD_SIZE ||
+            !tableFits(h->indexOffset, h->indexCount, sizeof(PackIndexEntry), size) ||
+            !tableFits(h->boardsOffset, h->boardCount, sizeof(PackBoard), size)) {
+            close();
+            return false;
+        }
+        header = h;
+        index = (const PackIndexEntry*)(data + h->indexOffset);
+        boards = (const PackBoard*)(data + h->boardsOffset);
+        return true;
+    }
+
+    void close() {
+#ifdef _WIN32
+        if (data != nullptr) UnmapViewOfFile(data);
+        if (mapping != nullptr) CloseHandle(mapping);
+        if (file != INVALID_HANDLE_VALUE) CloseHandle(file);
+        mapping = nullptr;
+        file = INVALID_HANDLE_VALUE;
+#else
+        if (data != nullptr) munmap((void*)data, size);
+        if (fd >= 0) ::close(fd);
+        fd = -1;
+#endif
+        data = nullptr;
+        size = 0;
+        header = nullptr;
+        index = nullptr;
+        boards = nullptr;
+    }
+
+    uint32_t boardCount() const {
+        return header != nullptr ? header->boardCount : 0;
+    }
+
+    // Đề số n; trả về false nếu n ngoài phạm vi
+    bool getBoard(uint32_t n, int* cells, PackBoard* info = nullptr) const {
+        if (n >= boardCount()) return false;
+        unpackCells(boards[n].cells, cells);
+        if (info != nullptr) *info = boards[n];
+        return true;
+    }
+
+    // Tìm kiếm nhị phân trong chỉ mục; trả về số đề hoặc -1
+    long findByDate(int day, int kind = PACK_DAILY) const {
+        if (header == nullptr) return -1;
+        uint32_t lo = 0, hi = header->indexCount;
+        while (lo < hi) {
+            uint32_t mid = lo + (hi - lo) / 2;
+            const PackIndexEntry& e = index[mid];
+            if (e.kind < kind || (e.kind == kind && e.day < day)) lo = mid + 1;
+            else hi = mid;
+        }
+        if (lo < header->indexCount && index[lo].kind == kind && index[lo].day == day &&
+            index[lo].board < header->boardCount) {
+            return index[lo].board;
+        }
+        return -1;
+    }
+
+private:
+    PuzzlePack(const PuzzlePack&);
+    PuzzlePack& operator=(const PuzzlePack&);
+};
+
+#endif
@@ -0,0 +1,189 @@
+// Công cụ tạo và kiểm tra gói đề (assets/puzzles.pack).
+//   PackBuilder <out.pack> <count> [YYYY-MM-DD] [seed]  tạo gói, đề 0 là đề của ngày bắt đầu
+//   PackBuilder --validate <file.pack>                  kiểm tra lại toàn bộ gói
+#define SDL_MAIN_HANDLED
+#include <atomic>
+#include <cstdio>
+#include <cstdlib>
+#include <thread>
+#include <vector>
+#include "defs.h"
+#include "analysis.h"
+#include "pack.h"
+#include "shuffle.h"
+
+using namespace std;
+
+// Ngưỡng số bước tối ưu cho từng mức độ khó
+const int BAND_LIMITS[] = {12, 18, 24};
+const int BAND_COUNT = 4;
+
+int bandForPar(int par) {
+    for (int i = 0; i < BAND_COUNT - 1; i++) {
+        if (par <= BAND_LIMITS[i]) return i;
+    }
+    return BAND_COUNT - 1;
+}
+
+unsigned workerCount() {
+    unsigned n = thread::hardware_concurrency();
+    return n == 0 ? 1 : n;
+}
+
+// Chia [0, count) thành các đoạn đều nhau cho từng luồng
+template <typename Fn>
+void parallelFor(uint32_t count, Fn fn) {
+    unsigned workers = workerCount();
+    vector<thread> threads;
+    for (unsigned w = 0; w < workers; w++) {
+        uint32_t begin = (uint32_t)((uint64_t)count * w / workers);
+        uint32_t end = (uint32_t)((uint64_t)count * (w + 1) / workers);
+        threads.push_back(thread(fn, begin, end));
+    }
+    for (size_t i = 0; i < threads.size(); i++) threads[i].join();
+}
+
+bool parseDate(const char* text, int& day) {
+    int y, m, d;
+    if (sscanf(text, "%d-%d-%d", &y, &m, &d) != 3 || m < 1 || m > 12 || d < 1 || d > 31) return false;
+    day = daysFromCivil(y, m, d);
+    return true;
+}
+
+bool writePadding(FILE* out, uint64_t bytes) {
+    const char zeros[16] = {0};
+    return bytes == 0 || fwrite(zeros, 1, (size_t)bytes, out) == bytes;
+}
+
+int build(const char* path, uint32_t count, int startDay, uint32_t baseSeed) {
+    vector<PackBoard> boards(count);
+    parallelFor(count, [&](uint32_t begin, uint32_t end) {
+        int cells[CELL_COUNT];
+        for (uint32_t i = begin; i < end; i++) {
+            uint32_t seed = (uint32_t)splitMix(((uint64_t)baseSeed << 32) | i);
+            generateBoard(seed, cells);
+            int par = distanceToGoal(cells);
+            PackBoard& b = boards[i];
+            b.cells = packCells(cells);
+            b.seed = seed;
+            b.par = (uint8_t)(par < 0 ? 0 : par);
+            b.band = (uint8_t)bandForPar(par);
+            b.flags = PACK_HAS_SEED | (par >= 0 ? PACK_HAS_PAR | PACK_HAS_BAND : 0);
+            b.reserved = 0;
+        }
+    });
+
+    // Đề ngày: đề i là của ngày startDay + i. Đề tuần: đề khó nhất trong mỗi tuần trọn vẹn.
+    vector<PackIndexEntry> index;
+    index.reserve(count + count / 7 + 1);
+    for (uint32_t i = 0; i < count; i++) {
+        PackIndexEntry e = {startDay + (int32_t)i, PACK_DAILY, 0, i};
+        index.push_back(e);
+    }
+    for (int week = weekStart(startDay); week + 7 <= startDay + (int)count; week += 7) {
+        if (week < startDay) continue;
+        uint32_t first = (uint32_t)(week - startDay);
+        uint32_t hardest = first;
+        for (uint32_t i = first + 1; i < first + 7; i++) {
+            if (boards[i].par > boards[hardest].par) hardest = i;
+        }
+        PackIndexEntry e = {week, PACK_WEEKLY, 0, hardest};
+        index.push_back(e);
+    }
+
+    PackHeader header;
+    memset(&header, 0, sizeof(header));
+    memcpy(header.magic, PACK_MAGIC, 4);
+    header.version = PACK_VERSION;
+    header.boardSize = BOARD_SIZE;
+    header.boardCount = count;
+    header.indexCount = (uint32_t)index.size();
+    header.indexOffset = alignOffset(sizeof(PackHeader), sizeof(PackIndexEntry));
+    header.boardsOffset = alignOffset(header.indexOffset + index.size() * sizeof(PackIndexEntry), sizeof(PackBoard));
+
+    FILE* out = fopen(path, "wb");
+    if (out == nullptr) {
+        fprintf(stderr, "Cannot open %s for writing\n", path);
+        return 1;
+    }
+    bool ok = fwrite(&header, sizeof(header), 1, out) == 1 &&
+              writePadding(out, header.indexOffset - sizeof(header)) &&
+              (index.empty() || fwrite(&index[0], sizeof(PackIndexEntry), index.size(), out) == index.size()) &&
+              writePadding(out, header.boardsOffset - header.indexOffset - index.size() * sizeof(PackIndexEntry)) &&
+              (boards.empty() || fwrite(&boards[0], sizeof(PackBoard), boards.size(), out) == boards.size());
+    if (fclose(out) != 0 || !ok) {
+        fprintf(stderr, "Failed to write %s\n", path);
+        return 1;
+    }
+    printf("Wrote %u boards and %u index entries to %s\n", count, header.indexCount, path);
+    return 0;
+}
+
+int validate(const char* path) {
+    PuzzlePack pack;
+    if (!pack.open(path)) {
+        fprintf(stderr, "%s is not a valid puzzle pack\n", path);
+        return 1;
+    }
+
+    long errors = 0;
+    for (uint32_t i = 0; i < pack.header->indexCount; i++) {
+        const PackIndexEntry& e = pack.index[i];
+        bool sorted = i == 0 || pack.index[i - 1].kind < e.kind ||
+                      (pack.index[i - 1].kind == e.kind && pack.index[i - 1].day < e.day);
+        if (!sorted || e.board >= pack.boardCount()) errors++;
+    }
+
+    atomic<long> badBoards(0);
+    parallelFor(pack.boardCount(), [&](uint32_t begin, uint32_t end) {
+        long bad = 0;
+        int cells[CELL_COUNT];
+        PackBoard info = PackBoard();
+        for (uint32_t i = begin; i < end; i++) {
+            pack.getBoard(i, cells, &info);
+            bool valid = isPermutation(cells);
+            int par = valid ? distanceToGoal(cells) : -1;
+            if (par < 0) valid = false;
+            if (valid && (info.flags & PACK_HAS_PAR) && info.par != par) valid = false;
+            if (valid && (info.flags & PACK_HAS_BAND) && info.band != bandForPar(par)) valid = false;
+            if (!valid) bad++;
+        }
+        badBoards += bad;
+    });
+    errors += badBoards;
+
+    printf("Checked %u boards and %u index entries: %ld error(s)\n", pack.boardCount(), pack.header->indexCount, errors);
+    return errors == 0 ? 0 : 1;
+}
+
+int main(int argc, char* argv[]) {
+    if (argc == 3 && strcmp(argv[1], "--validate") == 0) {
+#if BOARD_SIZE == 3
+        getDistanceTable().build();
+#endif
+        return validate(argv[2]);
+    }
+    if (argc < 3) {
+        fprintf(stderr, "Usage: %s <out.pack> <count> [YYYY-MM-DD] [seed]\n"
+                        "       %s --validate <file.pack>\n", argv[0], argv[0]);
+        return 1;
+    }
+
+    long count = strtol(argv[2], nullptr, 10);
+    if (count <= 0 || count > 0x7FFFFFFF) {
+        fprintf(stderr, "Invalid board count %s\n", argv[2]);
+        return 1;
+    }
+    int startDay = today();
+    if (argc >= 4 && !parseDate(argv[3], startDay)) {
+        fprintf(stderr, "Invalid date %s\n", argv[3]);
+        return 1;
+    }
+    uint32_t seed = argc >= 5 ? (uint32_t)strtoul(argv[4], nullptr, 10) : (uint32_t)time(0);
+
+#if BOARD_SIZE == 3
+    getDistanceTable().build(); // Dựng bảng trước khi chia luồng
+#endif
+    if (build(argv[1], (uint32_t)count, startDay, seed) != 0) return 1;
+    return validate(argv[1]);
+}
@@ -0,0 +1,237 @@
+#ifndef _RESOURCES__H
+#define _RESOURCES__H
+
+#include <atomic>
+#include <cstdlib>
+#include <new>
+#include <SDL.h>
+#include <SDL_image.h>
+#include <SDL_ttf.h>
+
+// Bộ đếm tài nguyên theo khung hình và tổng cộng.
+// Build có định nghĩa RESOURCE_BUDGET_STRICT (target Debug) sẽ dừng chương trình khi vượt ngân sách.
+enum ResourceCounter {
+    RES_HEAP_ALLOC,
+    RES_HEAP_FREE,
+    RES_SDL_ALLOC,
+    RES_SDL_FREE,
+    RES_TEXTURE_CREATE,
+    RES_TEXTURE_DESTROY,
+    RES_SURFACE_CREATE,
+    RES_SURFACE_DESTROY,
+    RES_FONT_OPEN,
+    RES_FONT_CLOSE,
+    RES_UPLOAD_BYTES,
+    RES_FILE_OPEN,
+    RES_COUNTER_COUNT
+};
+
+const char* RESOURCE_COUNTER_NAMES[RES_COUNTER_COUNT] = {
+    "heap allocs", "heap frees", "SDL allocs", "SDL frees",
+    "texture creates", "texture destroys", "surface creates", "surface destroys",
+    "font opens", "font closes", "upload bytes", "file opens"
+};
+
+#define RES_MAX_SCREENS 8
+#define RES_UNLIMITED -1
+
+// Bộ đếm là atomic vì cấp phát heap có thể đến từ luồng khác (âm thanh, mixer)
+struct ResourceStats {
+    std::atomic<long> frame[RES_COUNTER_COUNT];
+    std::atomic<long> total[RES_COUNTER_COUNT];
+    long budget[RES_MAX_SCREENS][RES_COUNTER_COUNT];
+    bool warned[RES_MAX_SCREENS][RES_COUNTER_COUNT];
+    bool transition; // Khung chuyển màn hình/ván mới: bộ nhớ đệm được nạp lại nên không xét ngân sách
+    long frameNumber;
+
+    ResourceStats() : transition(true), frameNumber(0) {
+        for (int i = 0; i < RES_COUNTER_COUNT; i++) {
+            frame[i] = 0;
+            total[i] = 0;
+        }
+        for (int s = 0; s < RES_MAX_SCREENS; s++) {
+            for (int i = 0; i < RES_COUNTER_COUNT; i++) {
+                budget[s][i] = RES_UNLIMITED;
+                warned[s][i] = false;
+            }
+        }
+    }
+
+    void count(ResourceCounter counter, long amount = 1) {
+        frame[counter].fetch_add(amount, std::memory_order_relaxed);
+        total[counter].fetch_add(amount, std::memory_order_relaxed);
+    }
+
+    void setBudget(int screen, ResourceCounter counter, long limit) {
+        budget[screen][counter] = limit;
+    }
+
+    void markTransition() {
+        transition = true;
+    }
+
+    void beginFrame() {
+        for (int i = 0; i < RES_COUNTER_COUNT; i++) frame[i] = 0;
+    }
+
+    void endFrame(int screen) {
+        frameNumber++;
+        if (transition) {
+            transition = false;
+            return;
+        }
+        for (int i = 0; i < RES_COUNTER_COUNT; i++) {
+            long limit = budget[screen][i];
+            long used = frame[i].load(std::memory_order_relaxed);
+            if (limit == RES_UNLIMITED || used <= limit) continue;
+#ifdef RESOURCE_BUDGET_STRICT
+            SDL_LogMessage(SDL_LOG_CATEGORY_APPLICATION, SDL_LOG_PRIORITY_CRITICAL, "Frame %ld on screen %d: %s %ld exceeds budget %ld",
+                           frameNumber, screen, RESOURCE_COUNTER_NAMES[i], used, limit);
+            abort();
+#else
+            if (!warned[screen][i]) {
+                warned[screen][i] = true;
+                SDL_LogMessage(SDL_LOG_CATEGORY_APPLICATION, SDL_LOG_PRIORITY_WARN, "Frame %ld on screen %d: %s %ld exceeds budget %ld",
+                               frameNumber, screen, RESOURCE_COUNTER_NAMES[i], used, limit);
+            }
+#endif
+        }
+    }
+
+    void logTotals() {
+        for (int i = 0; i < RES_COUNTER_COUNT; i++) {
+            SDL_LogMessage(SDL_LOG_CATEGORY_APPLICATION, SDL_LOG_PRIORITY_INFO, "Total %s: %ld", RESOURCE_COUNTER_NAMES[i], total[i].load());
+        }
+        if (total[RES_TEXTURE_CREATE] != total[RES_TEXTURE_DESTROY] || total[RES_SURFACE_CREATE] != total[RES_SURFACE_DESTROY] ||
+            total[RES_FONT_OPEN] != total[RES_FONT_CLOSE]) {
+            SDL_LogMessage(SDL_LOG_CATEGORY_APPLICATION, SDL_LOG_PRIORITY_WARN, "Resource leak: %ld textures, %ld surfaces, %ld fonts not released",
+                           total[RES_TEXTURE_CREATE].load() - total[RES_TEXTURE_DESTROY].load(),
+                           total[RES_SURFACE_CREATE].load() - total[RES_SURFACE_DESTROY].load(),
+                           total[RES_FONT_OPEN].load() - total[RES_FONT_CLOSE].load());
+        }
+    }
+};
+
+inline ResourceStats& resourceStats() {
+    static ResourceStats stats;
+    return stats;
+}
+
+// Bộ cấp phát bọc quanh hàm cấp phát của SDL; phải cài trước SDL_Init.
+// Chỉ đếm cấp phát của luồng chính (cả SDL lẫn new/delete) để luồng âm thanh không bị tính vào khung hình.
+struct SDLAllocator {
+    static SDL_threadID mainThread;
+    static SDL_malloc_func originalMalloc;
+    static SDL_calloc_func originalCalloc;
+    static SDL_realloc_func originalRealloc;
+    static SDL_free_func originalFree;
+
+    static bool onMainThread() {
+        return SDL_ThreadID() == mainThread;
+    }
+
+    static void* countedMalloc(size_t size) {
+        if (onMainThread()) resourceStats().count(RES_SDL_ALLOC);
+        return originalMalloc(size);
+    }
+
+    static void* countedCalloc(size_t count, size_t size) {
+        if (onMainThread()) resourceStats().count(RES_SDL_ALLOC);
+        return originalCalloc(count, size);
+    }
+
+    static void* countedRealloc(void* ptr, size_t size) {
+        if (ptr == nullptr && onMainThread()) resourceStats().count(RES_SDL_ALLOC);
+        return originalRealloc(ptr, size);
+    }
+
+    static void countedFree(void* ptr) {
+        if (ptr != nullptr && onMainThread()) resourceStats().count(RES_SDL_FREE);
+        originalFree(ptr);
+    }
+
+    static void install() {
+        mainThread = SDL_ThreadID();
+        SDL_GetMemoryFunctions(&originalMalloc, &originalCalloc, &originalRealloc, &originalFree);
+        SDL_SetMemoryFunctions(countedMalloc, countedCalloc, countedRealloc, countedFree);
+    }
+};
+
+SDL_threadID SDLAllocator::mainThread = 0;
+SDL_malloc_func SDLAllocator::originalMalloc = nullptr;
+SDL_calloc_func SDLAllocator::originalCalloc = nullptr;
+SDL_realloc_func SDLAllocator::originalRealloc = nullptr;
+SDL_free_func SDLAllocator::originalFree = nullptr;
+
+// Đếm cấp phát heap của C++ (new/delete, kể cả std::vector, fstream...) trên luồng chính
+void* operator new(size_t size) {
+    if (SDLAllocator::onMainThread()) resourceStats().count(RES_HEAP_ALLOC);
+    void* ptr = malloc(size == 0 ? 1 : size);
+    if (ptr == nullptr) throw std::bad_alloc();
+    return ptr;
+}
+
+void operator delete(void* ptr) noexcept {
+    if (ptr == nullptr) return;
+    if (SDLAllocator::onMainThread()) resourceStats().count(RES_HEAP_FREE);
+    free(ptr);
+}
+
+void operator delete(void* ptr, size_t) noexcept {
+    operator delete(ptr);
+}
+
+// Các hàm tạo/hủy tài nguyên SDL có đếm
+inline SDL_Texture* countedLoadTexture(SDL_Renderer* renderer, const char* filename) {
+    resourceStats().count(RES_FILE_OPEN);
+    SDL_Texture* texture = IMG_LoadTexture(renderer, filename);
+    if (texture != nullptr) {
+        int w, h;
+        SDL_QueryTexture(texture, NULL, NULL, &w, &h);
+        resourceStats().count(RES_TEXTURE_CREATE);
+        resourceStats().count(RES_UPLOAD_BYTES, (long)w * h * 4);
+    }
+    return texture;
+}
+
+inline SDL_Texture* countedCreateTexture(SDL_Renderer* renderer, SDL_Surface* surface) {
+    SDL_Texture* texture = SDL_CreateTextureFromSurface(renderer, surface);
+    if (texture != nullptr) {
+        resourceStats().count(RES_TEXTURE_CREATE);
+        resourceStats().count(RES_UPLOAD_BYTES, (long)surface->h * surface->pitch);
+    }
+    return texture;
+}
+
+inline void countedDestroyTexture(SDL_Texture* texture) {
+    if (texture == nullptr) return;
+    resourceStats().count(RES_TEXTURE_DESTROY);
+    SDL_DestroyTexture(texture);
+}
+
+inline SDL_Surface* countedRenderText(TTF_Font* font, const char* text, SDL_Color color) {
+    SDL_Surface* surface = TTF_RenderText_Solid(font, text, color);
+    if (surface != nullptr) resourceStats().count(RES_SURFACE_CREATE);
+    return surface;
+}
+
+inline void countedFreeSurface(SDL_Surface* surface) {
+    if (surface == nullptr) return;
+    resourceStats().count(RES_SURFACE_DESTROY);
+    SDL_FreeSurface(surface);
+}
+
+inline TTF_Font* countedOpenFont(const char* path, int size) {
+    resourceStats().count(RES_FILE_OPEN);
+    TTF_Font* font = TTF_OpenFont(path, size);
+    if (font != nullptr) resourceStats().count(RES_FONT_OPEN);
+    return font;
+}
+
+inline void countedCloseFont(TTF_Font* font) {
+    if (font == nullptr) return;
+    resourceStats().count(RES_FONT_CLOSE);
+    TTF_CloseFont(font);
+}
+
+#endif
@@ -0,0 +1,37 @@
+#ifndef _SHUFFLE__H
+#define _SHUFFLE__H
+
+#include <stdint.h>
+#include "defs.h"
+
+// Bộ sinh số ngẫu nhiên và bộ sinh bàn dùng chung cho các công cụ (PackBuilder, Simulator)
+inline uint64_t splitMix(uint64_t x) {
+    x += 0x9E3779B97F4A7C15ULL;
+    x = (x ^ (x >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    x = (x ^ (x >> 27)) * 0x94D049BB133111EBULL;
+    return x ^ (x >> 31);
+}
+
+// Sinh bàn giống SlidingPuzzle::init(): xáo trộn Fisher-Yates theo seed, lặp lại tới khi số nghịch thế chẵn
+inline void generateBoard(uint64_t seed, int* cells) {
+    uint64_t state = seed;
+    int inversions;
+    do {
+        for (int i = 0; i < BOARD_SIZE * BOARD_SIZE; i++) cells[i] = i;
+        for (int i = BOARD_SIZE * BOARD_SIZE - 1; i > 0; i--) {
+            state = splitMix(state);
+            int j = (int)(state % (uint64_t)(i + 1));
+            int temp = cells[i];
+            cells[i] = cells[j];
+            cells[j] = temp;
+        }
+        inversions = 0;
+        for (int i = 0; i < BOARD_SIZE * BOARD_SIZE - 1; i++) {
+            for (int j = i + 1; j < BOARD_SIZE * BOARD_SIZE; j++) {
+                if (cells[i] != EMPTY_CELL && cells[j] != EMPTY_CELL && cells[i] > cells[j]) inversions++;
+            }
+        }
+    } while (inversions % 2 != 0);
+}
+
+#endif
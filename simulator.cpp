@@ -0,0 +1,48 @@
+// Mô phỏng người chơi trên các bàn sinh như SlidingPuzzle::init() để hiệu chỉnh độ khó.
+//   Simulator <out.txt> <boards> <random|greedy|lookahead> [maxMoves] [seed] [threads]
+// Mỗi dòng kết quả: id số_bước đã_giải số_bước_tối_ưu bàn_ban_đầu(hex)
+#define SDL_MAIN_HANDLED
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include "simulator.h"
+
+using namespace std;
+
+int main(int argc, char* argv[]) {
+    if (argc < 4) {
+        fprintf(stderr, "Usage: %s <out.txt> <boards> <random|greedy|lookahead> [maxMoves] [seed] [threads]\n", argv[0]);
+        return 1;
+    }
+
+    SimConfig config;
+    config.boards = (uint32_t)strtoul(argv[2], nullptr, 10);
+    if (!parsePolicy(argv[3], config.policy)) {
+        fprintf(stderr, "Unknown policy %s\n", argv[3]);
+        return 1;
+    }
+    config.maxMoves = argc >= 5 ? (uint32_t)strtoul(argv[4], nullptr, 10) : 10000;
+    config.seed = argc >= 6 ? strtoull(argv[5], nullptr, 10) : (uint64_t)time(0);
+    config.threads = argc >= 7 ? (unsigned)strtoul(argv[6], nullptr, 10) : 0;
+    config.withPar = true;
+
+    FILE* out = fopen(argv[1], "w");
+    if (out == nullptr) {
+        fprintf(stderr, "Cannot open %s for writing\n", argv[1]);
+        return 1;
+    }
+
+    chrono::steady_clock::time_point begin = chrono::steady_clock::now();
+    Simulator simulator(config, out);
+    SimTotals totals = simulator.run();
+    double seconds = chrono::duration<double>(chrono::steady_clock::now() - begin).count();
+    if (fclose(out) != 0) {
+        fprintf(stderr, "Failed to write %s\n", argv[1]);
+        return 1;
+    }
+
+    printf("%s: %llu boards, %llu solved, %llu moves (avg %.1f) in %.2fs\n", SIM_POLICY_NAMES[config.policy],
+           (unsigned long long)totals.boards, (unsigned long long)totals.solved, (unsigned long long)totals.moves,
+           totals.boards > 0 ? (double)totals.moves / totals.boards : 0.0, seconds);
+    return 0;
+}
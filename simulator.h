@@ -0,0 +1,342 @@
+#ifndef _SIMULATOR__H
+#define _SIMULATOR__H
+
+#include <atomic>
+#include <cstdio>
+#include <mutex>
+#include <stdint.h>
+#include <string>
+#include <thread>
+#include <vector>
+#include "defs.h"
+#include "analysis.h"
+#include "shuffle.h"
+
+// Mô phỏng hàng loạt người chơi không cần giao diện.
+// Mỗi luồng giữ SIM_LANES bàn ở dạng cấu trúc-của-mảng và cho tất cả cùng đi một bước;
+// bàn nào xong thì được thay bằng bàn mới ở lần quét kế tiếp.
+#define SIM_LANES 1024
+#define SIM_STEPS_PER_SCAN 32
+#define SIM_NO_BOARD 0xFFFFFFFFu
+#define SIM_PENALTY 1024 // Điểm phạt cho nước không hợp lệ hoặc đi ngược lại
+
+static_assert(CELL_COUNT <= 16, "Simulator packs a board into 64 bits");
+
+enum SimPolicy { POLICY_RANDOM, POLICY_GREEDY, POLICY_LOOKAHEAD, POLICY_COUNT };
+
+const char* SIM_POLICY_NAMES[POLICY_COUNT] = {"random", "greedy", "lookahead"};
+
+// Bảng ô kề của từng vị trí ô trống, đệm bằng chính vị trí đó (nước đi rỗng) cho đủ 4
+struct NeighborTable {
+    uint8_t target[CELL_COUNT][4];
+    uint8_t count[CELL_COUNT];
+    uint8_t dist[16][CELL_COUNT]; // Khoảng cách Manhattan của ô số v khi nằm ở vị trí p
+    uint64_t goal;
+
+    NeighborTable() {
+        const int dr[4] = {-1, 1, 0, 0};
+        const int dc[4] = {0, 0, -1, 1};
+        for (int p = 0; p < CELL_COUNT; p++) {
+            int n = 0;
+            for (int d = 0; d < 4; d++) {
+                int r = p / BOARD_SIZE + dr[d], c = p % BOARD_SIZE + dc[d];
+                if (r < 0 || r >= BOARD_SIZE || c < 0 || c >= BOARD_SIZE) continue;
+                target[p][n++] = (uint8_t)(r * BOARD_SIZE + c);
+            }
+            count[p] = (uint8_t)n;
+            for (int d = n; d < 4; d++) target[p][d] = (uint8_t)p;
+        }
+        for (int v = 0; v < 16; v++) {
+            for (int p = 0; p < CELL_COUNT; p++) {
+                if (v == EMPTY_CELL || v >= CELL_COUNT) {
+                    dist[v][p] = 0;
+                } else {
+                    int goalPos = v - 1;
+                    dist[v][p] = (uint8_t)(abs(p / BOARD_SIZE - goalPos / BOARD_SIZE) + abs(p % BOARD_SIZE - goalPos % BOARD_SIZE));
+                }
+            }
+        }
+        goal = 0;
+        for (int p = 0; p < CELL_COUNT - 1; p++) goal |= (uint64_t)(p + 1) << (4 * p);
+    }
+};
+
+inline const NeighborTable& neighborTable() {
+    static NeighborTable table;
+    return table;
+}
+
+inline uint32_t xorshift32(uint32_t x) {
+    x ^= x << 13;
+    x ^= x >> 17;
+    x ^= x << 5;
+    return x;
+}
+
+inline int tileAt(uint64_t cells, int pos) {
+    return (int)((cells >> (4 * pos)) & 0xF);
+}
+
+// Bàn mới dạng 4 bit mỗi ô, kèm vị trí ô trống
+inline uint64_t generateSimBoard(uint64_t seed, int& empty) {
+    int values[CELL_COUNT];
+    generateBoard(seed, values);
+    uint64_t cells = 0;
+    for (int i = 0; i < CELL_COUNT; i++) {
+        cells |= (uint64_t)values[i] << (4 * i);
+        if (values[i] == EMPTY_CELL) empty = i;
+    }
+    return cells;
+}
+
+struct SimConfig {
+    SimPolicy policy;
+    uint32_t boards;
+    uint32_t maxMoves;  // Số bước tối đa cho mỗi bàn trước khi bỏ cuộc
+    uint64_t seed;
+    unsigned threads;   // 0 = theo số lõi
+    bool withPar;       // Ghi kèm số bước tối ưu (tra bảng khoảng cách)
+};
+
+struct SimTotals {
+    uint64_t moves;
+    uint64_t solved;
+    uint64_t boards;
+};
+
+// Các làn của một luồng, cấu trúc-của-mảng
+struct SimLanes {
+    uint64_t cells[SIM_LANES];
+    uint64_t start[SIM_LANES];
+    uint32_t rng[SIM_LANES];
+    uint32_t moves[SIM_LANES];
+    uint32_t id[SIM_LANES];
+    uint32_t active[SIM_LANES];
+    uint8_t empty[SIM_LANES];
+    uint8_t prevEmpty[SIM_LANES];
+    uint8_t manhattan[SIM_LANES];
+};
+
+// Chiến lược chọn nước: struct có hàm tĩnh choose(lanes, i, r, nt) trả về chỉ số nước k (0..3)
+// trong nt.target[e]. stepLanes được sinh riêng cho từng chiến lược nên choose được inline vào vòng lặp.
+struct RandomPolicy {
+    static int choose(const SimLanes& lanes, int i, uint32_t r, const NeighborTable& nt) {
+        return (int)(((uint64_t)r * nt.count[lanes.empty[i]]) >> 32);
+    }
+};
+
+// Chọn nước có điểm SCORE::score nhỏ nhất; 4 bit ngẫu nhiên mỗi nước để phá thế hòa.
+// Nước đệm và nước đi ngược lại bị phạt.
+template <typename SCORE>
+inline int chooseLowestScore(const SimLanes& lanes, int i, uint32_t r, const NeighborTable& nt) {
+    uint64_t cells = lanes.cells[i];
+    int e = lanes.empty[i];
+    int bestScore = 1 << 30;
+    int k = 0;
+    for (int c = 0; c < 4; c++) {
+        int t = nt.target[e][c];
+        int score = SCORE::score(lanes, i, nt, cells, e, t);
+        score = score * 64 + (int)((r >> (4 * c)) & 0xF);
+        score += SIM_PENALTY * 64 * ((c >= nt.count[e]) | (t == lanes.prevEmpty[i]));
+        k = score < bestScore ? c : k;
+        bestScore = score < bestScore ? score : bestScore;
+    }
+    return k;
+}
+
+// Tham lam: thay đổi khoảng cách Manhattan khi trượt ô ở t vào ô trống e
+struct GreedyPolicy {
+    static int score(const SimLanes&, int, const NeighborTable& nt, uint64_t cells, int e, int t) {
+        int tile = tileAt(cells, t);
+        return (int)nt.dist[tile][e] - (int)nt.dist[tile][t];
+    }
+
+    static int choose(const SimLanes& lanes, int i, uint32_t r, const NeighborTable& nt) {
+        return chooseLowestScore<GreedyPolicy>(lanes, i, r, nt);
+    }
+};
+
+// Như tham lam nhưng nhìn thêm một bước từ trạng thái sau nước đó (không tính đi ngược về e)
+struct LookaheadPolicy {
+    static int score(const SimLanes& lanes, int i, const NeighborTable& nt, uint64_t cells, int e, int t) {
+        int tile = tileAt(cells, t);
+        int score = (int)nt.dist[tile][e] - (int)nt.dist[tile][t];
+        uint64_t next = cells ^ ((uint64_t)tile << (4 * t)) ^ ((uint64_t)tile << (4 * e));
+        int best2 = SIM_PENALTY;
+        for (int c2 = 0; c2 < 4; c2++) {
+            int t2 = nt.target[t][c2];
+            int tile2 = tileAt(next, t2);
+            int s2 = (int)nt.dist[tile2][t] - (int)nt.dist[tile2][t2] +
+                     SIM_PENALTY * ((c2 >= nt.count[t]) | (t2 == e));
+            best2 = s2 < best2 ? s2 : best2;
+        }
+        int h1 = lanes.manhattan[i] + score;
+        return score + (h1 != 0) * best2;
+    }
+
+    static int choose(const SimLanes& lanes, int i, uint32_t r, const NeighborTable& nt) {
+        return chooseLowestScore<LookaheadPolicy>(lanes, i, r, nt);
+    }
+};
+
+// Một bước cho mọi làn, không rẽ nhánh theo dữ liệu: làn đã xong vẫn tính nhưng bị che bằng mặt nạ
+template <typename POLICY>
+void stepLanes(SimLanes& lanes, uint32_t maxMoves) {
+    const NeighborTable& nt = neighborTable();
+    for (int i = 0; i < SIM_LANES; i++) {
+        uint32_t r = xorshift32(lanes.rng[i]);
+        lanes.rng[i] = r;
+        uint64_t cells = lanes.cells[i];
+        int e = lanes.empty[i];
+        int k = POLICY::choose(lanes, i, r, nt);
+
+        int t = nt.target[e][k];
+        uint64_t tile = (uint64_t)tileAt(cells, t);
+        uint32_t a = lanes.active[i];
+        uint64_t mask = (uint64_t)0 - (uint64_t)a;
+        cells ^= ((tile << (4 * t)) ^ (tile << (4 * e))) & mask;
+        lanes.cells[i] = cells;
+        lanes.manhattan[i] = (uint8_t)(lanes.manhattan[i] + ((int)nt.dist[tile][e] - (int)nt.dist[tile][t]) * (int)a);
+        lanes.prevEmpty[i] = (uint8_t)(a ? e : lanes.prevEmpty[i]);
+        lanes.empty[i] = (uint8_t)(a ? t : e);
+        lanes.moves[i] += a;
+        lanes.active[i] = a & (uint32_t)(cells != nt.goal) & (uint32_t)(lanes.moves[i] < maxMoves);
+    }
+}
+
+struct Simulator {
+    SimConfig config;
+    FILE* out;                   // nullptr = không ghi kết quả (dùng cho benchmark)
+    std::atomic<uint32_t> nextBoard;
+    std::atomic<uint64_t> totalMoves;
+    std::atomic<uint64_t> totalSolved;
+    std::mutex outMutex;
+
+    Simulator(const SimConfig& cfg, FILE* output) : config(cfg), out(output), nextBoard(0), totalMoves(0), totalSolved(0) {}
+
+    void flush(std::string& buffer) {
+        if (out == nullptr || buffer.empty()) return;
+        std::lock_guard<std::mutex> lock(outMutex);
+        fwrite(buffer.data(), 1, buffer.size(), out);
+        buffer.clear();
+    }
+
+    // Lấy bàn kế tiếp từ hàng đợi chung; trả về false khi hết
+    bool fillLane(SimLanes& lanes, int i, uint32_t& rangeNext, uint32_t& rangeEnd) {
+        if (rangeNext == rangeEnd) {
+            rangeNext = nextBoard.fetch_add(SIM_LANES);
+            if (rangeNext >= config.boards) {
+                rangeNext = rangeEnd = config.boards;
+                lanes.id[i] = SIM_NO_BOARD;
+                lanes.active[i] = 0;
+                return false;
+            }
+            rangeEnd = rangeNext + SIM_LANES < config.boards ? rangeNext + SIM_LANES : config.boards;
+        }
+        uint32_t id = rangeNext++;
+        uint64_t seed = splitMix(config.seed ^ ((uint64_t)id << 20));
+        int empty = 0;
+        uint64_t cells = generateSimBoard(seed, empty);
+        const NeighborTable& nt = neighborTable();
+        int h = 0;
+        for (int p = 0; p < CELL_COUNT; p++) h += nt.dist[tileAt(cells, p)][p];
+
+        lanes.cells[i] = cells;
+        lanes.start[i] = cells;
+        lanes.rng[i] = (uint32_t)(seed >> 32) | 1;
+        lanes.moves[i] = 0;
+        lanes.id[i] = id;
+        lanes.empty[i] = (uint8_t)empty;
+        lanes.prevEmpty[i] = (uint8_t)CELL_COUNT; // Chưa có nước trước
+        lanes.manhattan[i] = (uint8_t)h;
+        lanes.active[i] = (uint32_t)(cells != nt.goal) & (uint32_t)(config.maxMoves > 0);
+        return true;
+    }
+
+    // Ghi kết quả: id, số bước, đã giải (1/0), số bước tối ưu (-1 nếu không tính), bàn ban đầu (hex)
+    void emit(const SimLanes& lanes, int i, std::string& buffer) {
+        bool solved = lanes.cells[i] == neighborTable().goal;
+        if (solved) totalSolved++;
+        if (out == nullptr) return;
+        int par = -1;
+        if (config.withPar) {
+            int cells[CELL_COUNT];
+            for (int p = 0; p < CELL_COUNT; p++) cells[p] = tileAt(lanes.start[i], p);
+            par = distanceToGoal(cells);
+        }
+        char line[96];
+        int n = snprintf(line, sizeof(line), "%u %u %d %d %016llx\n", lanes.id[i], lanes.moves[i], solved ? 1 : 0, par,
+                         (unsigned long long)lanes.start[i]);
+        buffer.append(line, n);
+        if (buffer.size() > (1 << 16)) flush(buffer);
+    }
+
+    template <typename POLICY>
+    void worker() {
+        std::vector<SimLanes> storage(1); // SimLanes lớn, không đặt trên stack
+        SimLanes& lanes = storage[0];
+        std::string buffer;
+        uint32_t rangeNext = 0, rangeEnd = 0;
+        int live = 0;
+        for (int i = 0; i < SIM_LANES; i++) {
+            if (fillLane(lanes, i, rangeNext, rangeEnd)) live++;
+        }
+
+        uint64_t moves = 0;
+        while (live > 0) {
+            for (int s = 0; s < SIM_STEPS_PER_SCAN; s++) {
+                stepLanes<POLICY>(lanes, config.maxMoves);
+            }
+            // Quét: làn đã xong thì ghi kết quả và nạp bàn mới
+            for (int i = 0; i < SIM_LANES; i++) {
+                if (lanes.active[i] || lanes.id[i] == SIM_NO_BOARD) continue;
+                moves += lanes.moves[i];
+                emit(lanes, i, buffer);
+                if (!fillLane(lanes, i, rangeNext, rangeEnd)) live--;
+            }
+        }
+        totalMoves += moves;
+        flush(buffer);
+    }
+
+    SimTotals run() {
+#if BOARD_SIZE == 3
+        if (config.withPar) getDistanceTable().build(); // Các luồng chỉ đọc bảng nên phải dựng xong ở đây
+#endif
+        neighborTable();
+
+        unsigned threads = config.threads;
+        if (threads == 0) threads = std::thread::hardware_concurrency();
+        if (threads == 0) threads = 1;
+
+        // Thứ tự khớp với SimPolicy và SIM_POLICY_NAMES
+        typedef void (Simulator::*Worker)();
+        const Worker workers[] = {&Simulator::worker<RandomPolicy>, &Simulator::worker<GreedyPolicy>, &Simulator::worker<LookaheadPolicy>};
+        static_assert(sizeof(workers) / sizeof(workers[0]) == POLICY_COUNT, "One worker per SimPolicy");
+        Worker worker = config.policy < POLICY_COUNT ? workers[config.policy] : workers[POLICY_RANDOM];
+
+        std::vector<std::thread> pool;
+        for (unsigned t = 0; t < threads; t++) {
+            pool.push_back(std::thread(worker, this));
+        }
+        for (size_t t = 0; t < pool.size(); t++) pool[t].join();
+
+        SimTotals totals;
+        totals.moves = totalMoves;
+        totals.solved = totalSolved;
+        totals.boards = config.boards;
+        return totals;
+    }
+};
+
+inline bool parsePolicy(const char* name, SimPolicy& policy) {
+    for (int i = 0; i < POLICY_COUNT; i++) {
+        if (strcmp(name, SIM_POLICY_NAMES[i]) == 0) {
+            policy = (SimPolicy)i;
+            return true;
+        }
+    }
+    return false;
+}
+
+#endif
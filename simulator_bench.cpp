@@ -0,0 +1,32 @@
+// Đo tốc độ mô phỏng (bước/giây) cho từng chiến lược, không ghi file.
+//   SimulatorBench [boards] [maxMoves] [threads]
+#define SDL_MAIN_HANDLED
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include "simulator.h"
+
+using namespace std;
+
+int main(int argc, char* argv[]) {
+    SimConfig config;
+    config.boards = argc >= 2 ? (uint32_t)strtoul(argv[1], nullptr, 10) : 1 << 18;
+    config.maxMoves = argc >= 3 ? (uint32_t)strtoul(argv[2], nullptr, 10) : 1000;
+    config.threads = argc >= 4 ? (unsigned)strtoul(argv[3], nullptr, 10) : 0;
+    config.seed = 12345;
+    config.withPar = false;
+
+    unsigned threads = config.threads != 0 ? config.threads : thread::hardware_concurrency();
+    printf("%u boards, max %u moves, %u thread(s)\n", config.boards, config.maxMoves, threads);
+    for (int p = 0; p < POLICY_COUNT; p++) {
+        config.policy = (SimPolicy)p;
+        chrono::steady_clock::time_point begin = chrono::steady_clock::now();
+        Simulator simulator(config, nullptr);
+        SimTotals totals = simulator.run();
+        double seconds = chrono::duration<double>(chrono::steady_clock::now() - begin).count();
+        printf("%-10s %12llu moves %9llu solved %8.3fs %10.1f M moves/s\n", SIM_POLICY_NAMES[p],
+               (unsigned long long)totals.moves, (unsigned long long)totals.solved, seconds,
+               seconds > 0 ? totals.moves / seconds / 1e6 : 0.0);
+    }
+    return 0;
+}